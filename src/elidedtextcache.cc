@@ -0,0 +1,134 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "elidedtextcache.h"
+
+#include <QHash>
+
+#include <limits.h>
+
+namespace {
+
+const QString THREE_DOTS = QStringLiteral("...");
+
+}
+
+uint qHash(const ElidedTextCache::Key &key, uint seed)
+{
+    return qHash(key.path, seed) ^ qHash((key.fontId << 20) ^ key.bucket, seed);
+}
+
+ElidedTextCache *ElidedTextCache::instance()
+{
+    static ElidedTextCache cache;
+    return &cache;
+}
+
+ElidedTextCache::ElidedTextCache(int maxEntries)
+    : m_entries(maxEntries)
+{
+}
+
+int ElidedTextCache::fontId(const QFont &font)
+{
+    const int index = m_fonts.indexOf(font);
+    if (index >= 0) {
+        return index;
+    }
+
+    m_fonts.append(font);
+    m_metrics.append(QFontMetrics(font));
+    return m_fonts.size() - 1;
+}
+
+QString ElidedTextCache::fileName(PathTable::PathId path)
+{
+    const Entry *entry = lookup(path, -1, -1);
+    return entry ? entry->text : QString();
+}
+
+QString ElidedTextCache::elidedFileName(PathTable::PathId path, int fontId, int width, int *nextWidth)
+{
+    int next = INT_MAX;
+    QString text;
+
+    const Entry *full = (fontId >= 0 ? lookup(path, fontId, -1) : nullptr);
+    if (full && full->width <= width) {
+        text = full->text;
+    } else if (full && width >= 0) {
+        const Entry *elided = lookup(path, fontId, width / WidthBucket);
+        text = elided->text;
+        next = elided->width;
+    }
+
+    if (nextWidth) {
+        *nextWidth = next;
+    }
+    return text;
+}
+
+const ElidedTextCache::Entry *ElidedTextCache::lookup(PathTable::PathId path, int fontId, int bucket)
+{
+    if (path == 0 || fontId >= m_metrics.size()) {
+        return nullptr;
+    }
+
+    const Key key = { path, fontId, bucket };
+    if (const Entry *entry = m_entries.object(key)) {
+        return entry;
+    }
+
+    Entry *entry = new Entry;
+    if (fontId < 0) {
+        const QString filePath = PathTable::path(path);
+        entry->text = filePath.mid(filePath.lastIndexOf(QLatin1Char('/')) + 1);
+        entry->width = 0;
+    } else if (bucket < 0) {
+        entry->text = fileName(path);
+        entry->width = m_metrics.at(fontId).width(entry->text);
+    } else {
+        const QFontMetrics &fm = m_metrics.at(fontId);
+        const QString name = fileName(path);
+        const int width = bucket * WidthBucket;
+        const int threeDotsWidth = fm.width(THREE_DOTS);
+
+        // the longest prefix that fits together with the dots
+        int lo = 0;
+        int hi = name.length();
+        while (lo < hi) {
+            const int mid = (lo + hi + 1) / 2;
+            if (fm.width(name.left(mid)) + threeDotsWidth <= width) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        if (threeDotsWidth <= width) {
+            entry->text = name.left(lo) + THREE_DOTS;
+        }
+        // round up, the text only changes at bucket boundaries
+        const int next = fm.width(name.left(lo + 1)) + threeDotsWidth;
+        entry->width = (next + WidthBucket - 1) / WidthBucket * WidthBucket;
+    }
+
+    m_entries.insert(key, entry);
+    return entry;
+}
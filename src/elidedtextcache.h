@@ -0,0 +1,97 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_ELIDEDTEXTCACHE_H
+#define ICEMON_ELIDEDTEXTCACHE_H
+
+#include "pathtable.h"
+
+#include <QCache>
+#include <QFont>
+#include <QFontMetrics>
+#include <QList>
+#include <QString>
+
+/**
+ * Shared cache of shortened file names for labels
+ *
+ * Entries are keyed by the interned path, the font and the available width
+ * rounded down to WidthBucket pixels, and the least recently used ones are
+ * evicted. Eliding does a binary search over the prefix length, so a miss
+ * costs O(log n) text measurements for a name of n characters.
+ *
+ * Not thread-safe, only use it from the GUI thread.
+ */
+class ElidedTextCache
+{
+public:
+    enum {
+        WidthBucket = 8,
+        DefaultMaxEntries = 20000
+    };
+
+    static ElidedTextCache *instance();
+
+    explicit ElidedTextCache(int maxEntries = DefaultMaxEntries);
+
+    /// Small integer identifying @p font in the cache keys
+    int fontId(const QFont &font);
+
+    /// File name of @p path without its directory
+    QString fileName(PathTable::PathId path);
+
+    /**
+     * File name of @p path, shortened to @p width pixels with "..." if needed
+     *
+     * @param nextWidth set to the smallest width for which the result differs,
+     *                  or INT_MAX if the name is not shortened
+     */
+    QString elidedFileName(PathTable::PathId path, int fontId, int width, int *nextWidth = nullptr);
+
+private:
+    struct Key
+    {
+        PathTable::PathId path;
+        int fontId;
+        int bucket;     ///< -1 for the file name itself
+
+        bool operator==(const Key &other) const
+        {
+            return path == other.path && fontId == other.fontId && bucket == other.bucket;
+        }
+    };
+    friend uint qHash(const Key &key, uint seed);
+
+    struct Entry
+    {
+        QString text;
+        int width;      ///< of the text, or the next width for elided entries
+    };
+
+    const Entry *lookup(PathTable::PathId path, int fontId, int bucket);
+
+    QCache<Key, Entry> m_entries;
+    QList<QFont> m_fonts;
+    QList<QFontMetrics> m_metrics;
+
+    Q_DISABLE_COPY(ElidedTextCache)
+};
+
+#endif // ICEMON_ELIDEDTEXTCACHE_H
@@ -0,0 +1,344 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "eventlog.h"
+
+#include "monitorevent.h"
+
+#include <QCoreApplication>
+#include <QtEndian>
+
+#include <string.h>
+
+namespace {
+
+const char MAGIC[8] = { 'I', 'C', 'E', 'M', 'O', 'N', 'E', 'V' };
+
+// size, timestamp, type
+const int RECORD_HEADER_SIZE = 4 + 8 + 1;
+
+template<typename T>
+void put(QByteArray *out, T value)
+{
+    uchar buf[sizeof(T)];
+    qToLittleEndian<T>(value, buf);
+    out->append(reinterpret_cast<const char *>(buf), sizeof(T));
+}
+
+void putString(QByteArray *out, const QString &str)
+{
+    QByteArray utf8 = str.toUtf8();
+    if (utf8.size() > 0xffff) {
+        utf8.truncate(0xffff);
+    }
+    put<quint16>(out, quint16(utf8.size()));
+    out->append(utf8);
+}
+
+void putBytes(QByteArray *out, const QByteArray &bytes)
+{
+    put<quint32>(out, quint32(bytes.size()));
+    out->append(bytes);
+}
+
+/// Bounds-checked reader over a mapped record
+class Cursor
+{
+public:
+    Cursor(const uchar *data, qint64 size)
+        : m_data(data)
+        , m_end(data + size)
+        , m_ok(true) {}
+
+    bool isOk() const { return m_ok; }
+
+    template<typename T>
+    T get()
+    {
+        if (m_end - m_data < qint64(sizeof(T))) {
+            m_ok = false;
+            return T();
+        }
+        const T value = qFromLittleEndian<T>(m_data);
+        m_data += sizeof(T);
+        return value;
+    }
+
+    QByteArray getBytes()
+    {
+        const quint32 size = get<quint32>();
+        if (!m_ok || quint64(m_end - m_data) < size) {
+            m_ok = false;
+            return QByteArray();
+        }
+        const QByteArray bytes(reinterpret_cast<const char *>(m_data), int(size));
+        m_data += size;
+        return bytes;
+    }
+
+    QString getString()
+    {
+        const quint16 size = get<quint16>();
+        if (!m_ok || m_end - m_data < size) {
+            m_ok = false;
+            return QString();
+        }
+        const QString str = QString::fromUtf8(reinterpret_cast<const char *>(m_data), size);
+        m_data += size;
+        return str;
+    }
+
+private:
+    const uchar *m_data;
+    const uchar *m_end;
+    bool m_ok;
+};
+
+}
+
+EventLogWriter::EventLogWriter()
+{
+}
+
+EventLogWriter::~EventLogWriter()
+{
+    close();
+}
+
+bool EventLogWriter::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QByteArray header(MAGIC, sizeof(MAGIC));
+    put<quint32>(&header, EventLog::Version);
+    put<quint32>(&header, 0);
+    m_file.write(header);
+
+    m_clock.start();
+    return true;
+}
+
+void EventLogWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+void EventLogWriter::write(const MonitorEvent &event)
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    QByteArray &record = m_record;
+    record.resize(0);
+    put<quint32>(&record, 0); // patched below
+    put<qint64>(&record, m_clock.elapsed());
+    put<quint8>(&record, quint8(event.type));
+
+    switch (event.type) {
+    case MonitorEvent::SchedulerOnline:
+        putString(&record, event.schedulerName);
+        putString(&record, event.networkName);
+        break;
+    case MonitorEvent::SchedulerOffline:
+        break;
+    case MonitorEvent::JobRequested:
+    case MonitorEvent::LocalJobBegin:
+        put<quint32>(&record, event.jobId);
+        put<quint32>(&record, event.hostId);
+        put<quint8>(&record, quint8(event.lang));
+        putString(&record, event.fileName);
+        break;
+    case MonitorEvent::JobBegin:
+        put<quint32>(&record, event.jobId);
+        put<quint32>(&record, event.hostId);
+        put<qint64>(&record, qint64(event.startTime));
+        break;
+    case MonitorEvent::JobDone:
+        put<quint32>(&record, event.jobId);
+        put<qint32>(&record, event.exitcode);
+        put<quint32>(&record, event.real_msec);
+        put<quint32>(&record, event.user_msec);
+        put<quint32>(&record, event.sys_msec);
+        put<quint32>(&record, event.pfaults);
+        put<quint32>(&record, event.in_compressed);
+        put<quint32>(&record, event.in_uncompressed);
+        put<quint32>(&record, event.out_compressed);
+        put<quint32>(&record, event.out_uncompressed);
+        break;
+    case MonitorEvent::LocalJobDone:
+        put<quint32>(&record, event.jobId);
+        break;
+    case MonitorEvent::HostStats:
+        put<quint32>(&record, event.hostId);
+        putBytes(&record, event.stats.message());
+        break;
+    }
+
+    qToLittleEndian<quint32>(quint32(record.size()), reinterpret_cast<uchar *>(record.data()));
+    m_file.write(record);
+}
+
+EventLogReader::EventLogReader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_pos(0)
+{
+}
+
+EventLogReader::~EventLogReader()
+{
+    close();
+}
+
+bool EventLogReader::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    m_data = (size > 0 ? m_file.map(0, size) : nullptr);
+    if (!m_data) {
+        m_errorString = QCoreApplication::translate("EventLogReader", "Cannot map %1").arg(fileName);
+        close();
+        return false;
+    }
+    m_size = size;
+
+    if (m_size < EventLog::HeaderSize || memcmp(m_data, MAGIC, sizeof(MAGIC)) != 0) {
+        m_errorString = QCoreApplication::translate("EventLogReader", "%1 is not an event log").arg(fileName);
+        close();
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(m_data + sizeof(MAGIC)) > EventLog::Version) {
+        m_errorString = QCoreApplication::translate("EventLogReader", "Unsupported event log version in %1").arg(fileName);
+        close();
+        return false;
+    }
+
+    rewind();
+    return true;
+}
+
+void EventLogReader::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_pos = 0;
+}
+
+void EventLogReader::rewind()
+{
+    m_pos = qMin<qint64>(EventLog::HeaderSize, m_size);
+}
+
+qint64 EventLogReader::nextTimestamp() const
+{
+    Cursor cursor(m_data + m_pos, m_size - m_pos);
+    cursor.get<quint32>();
+    return cursor.get<qint64>();
+}
+
+bool EventLogReader::next(MonitorEvent *event, qint64 *timestamp)
+{
+    while (!atEnd()) {
+        Cursor header(m_data + m_pos, m_size - m_pos);
+        const quint32 size = header.get<quint32>();
+        const qint64 time = header.get<qint64>();
+        const quint8 type = header.get<quint8>();
+        if (!header.isOk() || size < quint32(RECORD_HEADER_SIZE) || size > quint64(m_size - m_pos)) {
+            // truncated, e.g. the recording was still being written
+            m_pos = m_size;
+            return false;
+        }
+
+        Cursor cursor(m_data + m_pos + RECORD_HEADER_SIZE, size - RECORD_HEADER_SIZE);
+        m_pos += size;
+
+        *event = MonitorEvent(MonitorEvent::Type(type));
+        switch (type) {
+        case MonitorEvent::SchedulerOnline:
+            event->schedulerName = cursor.getString();
+            event->networkName = cursor.getString();
+            break;
+        case MonitorEvent::SchedulerOffline:
+            break;
+        case MonitorEvent::JobRequested:
+        case MonitorEvent::LocalJobBegin:
+            event->jobId = cursor.get<quint32>();
+            event->hostId = cursor.get<quint32>();
+            event->lang = Job::Language(cursor.get<quint8>());
+            event->fileName = cursor.getString();
+            break;
+        case MonitorEvent::JobBegin:
+            event->jobId = cursor.get<quint32>();
+            event->hostId = cursor.get<quint32>();
+            event->startTime = time_t(cursor.get<qint64>());
+            break;
+        case MonitorEvent::JobDone:
+            event->jobId = cursor.get<quint32>();
+            event->exitcode = cursor.get<qint32>();
+            event->real_msec = cursor.get<quint32>();
+            event->user_msec = cursor.get<quint32>();
+            event->sys_msec = cursor.get<quint32>();
+            event->pfaults = cursor.get<quint32>();
+            event->in_compressed = cursor.get<quint32>();
+            event->in_uncompressed = cursor.get<quint32>();
+            event->out_compressed = cursor.get<quint32>();
+            event->out_uncompressed = cursor.get<quint32>();
+            break;
+        case MonitorEvent::LocalJobDone:
+            event->jobId = cursor.get<quint32>();
+            break;
+        case MonitorEvent::HostStats:
+            event->hostId = cursor.get<quint32>();
+            event->stats = HostStats(cursor.getBytes());
+            break;
+        default:
+            // written by a newer version, skip it
+            continue;
+        }
+
+        if (!cursor.isOk()) {
+            continue;
+        }
+        if (timestamp) {
+            *timestamp = time;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,109 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_EVENTLOG_H
+#define ICEMON_EVENTLOG_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+struct MonitorEvent;
+
+/**
+ * Binary log of decoded scheduler traffic
+ *
+ * All integers are little-endian. The file starts with a 16 byte header:
+ * the magic "ICEMONEV", a quint32 version and a quint32 reserved for flags.
+ *
+ * Each record starts with a quint32 holding the size of the whole record,
+ * a qint64 timestamp in milliseconds since the recording started and the
+ * quint8 MonitorEvent::Type, followed by the fields used by that type.
+ * Strings are stored as quint16 length plus UTF-8 data. Host statistics are
+ * stored as the raw message with a quint32 length.
+ *
+ * Records are self-delimiting, so readers can skip types they do not know.
+ */
+namespace EventLog {
+enum {
+    Version = 1,
+    HeaderSize = 16
+};
+}
+
+class EventLogWriter
+{
+public:
+    EventLogWriter();
+    ~EventLogWriter();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_file.errorString(); }
+
+    /// Append @p event, timestamped with the time elapsed since open()
+    void write(const MonitorEvent &event);
+
+private:
+    QFile m_file;
+    QElapsedTimer m_clock;
+    QByteArray m_record;
+
+    Q_DISABLE_COPY(EventLogWriter)
+};
+
+class EventLogReader
+{
+public:
+    EventLogReader();
+    ~EventLogReader();
+
+    /// Maps @p fileName into memory and validates the header
+    bool open(const QString &fileName);
+    void close();
+    QString errorString() const { return m_errorString; }
+
+    /// Rewind to the first record
+    void rewind();
+    bool atEnd() const { return m_pos >= m_size; }
+
+    /// Timestamp of the next record, only valid if !atEnd()
+    qint64 nextTimestamp() const;
+
+    /**
+     * Decode the next record into @p event
+     *
+     * @return false at the end of the log or if the record is truncated
+     */
+    bool next(MonitorEvent *event, qint64 *timestamp = nullptr);
+
+private:
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    qint64 m_pos;
+    QString m_errorString;
+
+    Q_DISABLE_COPY(EventLogReader)
+};
+
+#endif // ICEMON_EVENTLOG_H
@@ -0,0 +1,217 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2003 Frerich Raabe <raabe@kde.org>
+    Copyright (c) 2003,2004 Stephan Kulow <coolo@kde.org>
+    Copyright (c) 2003,2004 Cornelius Schumacher <schumacher@kde.org>
+    Copyright (c) 2007 Dirk Mueller <mueller@kde.org>
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "eventmonitor.h"
+
+#include "eventlog.h"
+#include "hostinfo.h"
+#include "monitorevent.h"
+
+#include <QDebug>
+
+namespace {
+
+/// Jobs whose done message got lost would otherwise be remembered forever
+const int MAX_REMEMBERED_JOBS = 10000;
+
+}
+
+EventMonitor::EventMonitor(HostInfoManager *manager, QObject *parent)
+    : Monitor(manager, parent)
+    , m_recorder(nullptr)
+{
+}
+
+EventMonitor::~EventMonitor()
+{
+    delete m_recorder;
+}
+
+bool EventMonitor::startRecording(const QString &fileName)
+{
+    stopRecording();
+
+    m_recorder = new EventLogWriter;
+    if (!m_recorder->open(fileName)) {
+        qWarning() << "Cannot record to" << fileName << m_recorder->errorString();
+        stopRecording();
+        return false;
+    }
+
+    if (schedulerState() == Online) {
+        // make the log self-contained when starting in the middle of a session
+        MonitorEvent event(MonitorEvent::SchedulerOnline);
+        event.schedulerName = hostInfoManager()->schedulerName();
+        event.networkName = hostInfoManager()->networkName();
+        m_recorder->write(event);
+    }
+    return true;
+}
+
+void EventMonitor::stopRecording()
+{
+    delete m_recorder;
+    m_recorder = nullptr;
+}
+
+JobList EventMonitor::activeJobs() const
+{
+    return m_rememberedJobs;
+}
+
+void EventMonitor::handleEvent(const MonitorEvent &event)
+{
+    if (m_recorder) {
+        m_recorder->write(event);
+    }
+
+    switch (event.type) {
+    case MonitorEvent::SchedulerOnline:
+        handle_scheduler_online(event);
+        break;
+    case MonitorEvent::SchedulerOffline:
+        handle_scheduler_offline();
+        break;
+    case MonitorEvent::JobRequested:
+        handle_getcs(event);
+        break;
+    case MonitorEvent::JobBegin:
+        handle_job_begin(event);
+        break;
+    case MonitorEvent::JobDone:
+        handle_job_done(event);
+        break;
+    case MonitorEvent::HostStats:
+        handle_stats(event);
+        break;
+    case MonitorEvent::LocalJobBegin:
+        handle_local_begin(event);
+        break;
+    case MonitorEvent::LocalJobDone:
+        handle_local_done(event);
+        break;
+    }
+}
+
+void EventMonitor::handle_scheduler_online(const MonitorEvent &event)
+{
+    hostInfoManager()->setSchedulerName(event.schedulerName);
+    hostInfoManager()->setNetworkName(event.networkName);
+    setSchedulerState(Online);
+}
+
+void EventMonitor::handle_scheduler_offline()
+{
+    m_rememberedJobs.clear();
+    setSchedulerState(Offline);
+}
+
+void EventMonitor::rememberJob(const Job &job)
+{
+    if (m_rememberedJobs.size() >= MAX_REMEMBERED_JOBS && !m_rememberedJobs.contains(job.id)) {
+        // drop the oldest job, it is most likely stale
+        m_rememberedJobs.erase(m_rememberedJobs.begin());
+    }
+    m_rememberedJobs[job.id] = job;
+    notifyJobUpdated(job);
+}
+
+void EventMonitor::handle_getcs(const MonitorEvent &event)
+{
+    rememberJob(Job(event.jobId, event.hostId, event.fileName, event.lang));
+}
+
+void EventMonitor::handle_local_begin(const MonitorEvent &event)
+{
+    Job job(event.jobId, event.hostId, event.fileName, event.lang);
+    job.state = Job::LocalOnly;
+    rememberJob(job);
+}
+
+void EventMonitor::handle_local_done(const MonitorEvent &event)
+{
+    JobList::iterator it = m_rememberedJobs.find(event.jobId);
+    if (it == m_rememberedJobs.end()) {
+        // we started in between
+        return;
+    }
+
+    (*it).state = Job::Finished;
+    notifyJobUpdated(*it);
+    m_rememberedJobs.erase(it);
+}
+
+void EventMonitor::handle_stats(const MonitorEvent &event)
+{
+    HostInfo *hostInfo = hostInfoManager()->checkNode(event.hostId, event.stats);
+
+    if (hostInfo->isOffline()) {
+        emit nodeRemoved(event.hostId);
+    } else {
+        emit nodeUpdated(event.hostId);
+    }
+}
+
+void EventMonitor::handle_job_begin(const MonitorEvent &event)
+{
+    JobList::iterator it = m_rememberedJobs.find(event.jobId);
+    if (it == m_rememberedJobs.end()) {
+        // we started in between
+        return;
+    }
+
+    (*it).server = event.hostId;
+    (*it).startTime = event.startTime;
+    (*it).state = Job::Compiling;
+
+    notifyJobUpdated(*it);
+}
+
+void EventMonitor::handle_job_done(const MonitorEvent &event)
+{
+    JobList::iterator it = m_rememberedJobs.find(event.jobId);
+    if (it == m_rememberedJobs.end()) {
+        // we started in between
+        return;
+    }
+
+    (*it).exitcode = event.exitcode;
+    if (event.exitcode) {
+        (*it).state = Job::Failed;
+    } else {
+        (*it).state = Job::Finished;
+        (*it).real_msec = event.real_msec;
+        (*it).user_msec = event.user_msec;
+        (*it).sys_msec = event.sys_msec;     /* system time used */
+        (*it).pfaults = event.pfaults;       /* page faults */
+
+        (*it).in_compressed = event.in_compressed;
+        (*it).in_uncompressed = event.in_uncompressed;
+        (*it).out_compressed = event.out_compressed;
+        (*it).out_uncompressed = event.out_uncompressed;
+    }
+
+    notifyJobUpdated(*it);
+    m_rememberedJobs.erase(it);
+}
@@ -0,0 +1,82 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2003 Frerich Raabe <raabe@kde.org>
+    Copyright (c) 2003,2004 Stephan Kulow <coolo@kde.org>
+    Copyright (c) 2003,2004 Cornelius Schumacher <schumacher@kde.org>
+    Copyright (c) 2007 Dirk Mueller <mueller@kde.org>
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_EVENTMONITOR_H
+#define ICEMON_EVENTMONITOR_H
+
+#include "monitor.h"
+
+class EventLogWriter;
+class HostInfoManager;
+struct MonitorEvent;
+
+/**
+ * Monitor driven by decoded scheduler events
+ *
+ * Keeps track of the jobs in flight and applies MonitorEvent instances to
+ * them and to the host info manager. Subclasses only decide where the events
+ * come from, e.g. a live scheduler connection or a recorded log.
+ */
+class EventMonitor
+    : public Monitor
+{
+    Q_OBJECT
+
+public:
+    explicit EventMonitor(HostInfoManager *manager, QObject *parent = nullptr);
+    ~EventMonitor();
+
+    virtual JobList activeJobs() const override;
+
+    /**
+     * Write every event handled from now on to the event log @p fileName
+     *
+     * @return false if the file could not be opened
+     */
+    bool startRecording(const QString &fileName);
+    void stopRecording();
+    bool isRecording() const { return m_recorder; }
+
+protected:
+    void handleEvent(const MonitorEvent &event);
+
+private:
+    void handle_scheduler_online(const MonitorEvent &event);
+    void handle_scheduler_offline();
+    void handle_getcs(const MonitorEvent &event);
+    void handle_job_begin(const MonitorEvent &event);
+    void handle_job_done(const MonitorEvent &event);
+    void handle_stats(const MonitorEvent &event);
+    void handle_local_begin(const MonitorEvent &event);
+    void handle_local_done(const MonitorEvent &event);
+
+    void rememberJob(const Job &job);
+
+    /// Jobs which have not finished yet, finished ones go to the job history
+    JobList m_rememberedJobs;
+
+    EventLogWriter *m_recorder;
+};
+
+#endif // ICEMON_EVENTMONITOR_H
@@ -20,7 +20,6 @@
 
 #include "fakemonitor.h"
 
-#include "statusview.h"
 #include "job.h"
 #include "hostinfo.h"
 
@@ -73,6 +72,15 @@ FakeMonitor::FakeMonitor(HostInfoManager *manager, QObject *parent)
     qsrand(QTime::currentTime().msec());
 }
 
+JobList FakeMonitor::activeJobs() const
+{
+    JobList jobs;
+    foreach(const Job &job, m_activeJobs) {
+        jobs.insert(job.id, job);
+    }
+    return jobs;
+}
+
 void FakeMonitor::createHostInfo(HostId id)
 {
     HostInfo info(id);
@@ -105,7 +113,7 @@ void FakeMonitor::update()
     job.real_msec = 200;
     const int serverId = ((JOB_ID + 1) % MAX_HOST_COUNT) + 1;
     job.server = serverId;
-    emit jobUpdated(job);
+    notifyJobUpdated(job);
     m_activeJobs << job;
 
     // clean up old jobs
@@ -113,10 +121,10 @@ void FakeMonitor::update()
         Job job = m_activeJobs.first();
         m_activeJobs.removeFirst();
         job.state = Job::Finished;
-        emit jobUpdated(job);
+        notifyJobUpdated(job);
     }
 
-    Q_FOREACH(const HostInfo * info, hostInfoManager()->hostMap().values()) {
+    Q_FOREACH(const HostInfo * info, hostInfoManager()->hosts()) {
         if (info->isOffline()) {
             emit nodeRemoved(info->id());
         } else {
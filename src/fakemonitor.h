@@ -38,6 +38,8 @@ class FakeMonitor
 public:
     explicit FakeMonitor(HostInfoManager *manager, QObject *parent = nullptr);
 
+    virtual JobList activeJobs() const override;
+
 private Q_SLOTS:
     void update();
 
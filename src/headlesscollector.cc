@@ -0,0 +1,152 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "headlesscollector.h"
+
+#include "hostinfo.h"
+#include "monitor.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <stdio.h>
+
+HeadlessCollector::HeadlessCollector(Monitor *monitor, QObject *parent)
+    : QObject(parent)
+    , m_monitor(monitor)
+    , m_timer(new QTimer(this))
+{
+    // a coarse timer keeps the process asleep between reports
+    m_timer->setTimerType(Qt::VeryCoarseTimer);
+    m_timer->setInterval(60 * 1000);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(writeReport()));
+    m_timer->start();
+
+    m_monitor->jobHistory().readSettings();
+
+    // nothing is drawn, batching job updates once a second is plenty;
+    // writeReport() flushes the pending batch before reporting
+    m_monitor->setFlushInterval(1000);
+    connect(m_monitor.data(), SIGNAL(jobsUpdated(QVector<Job>)), this, SLOT(updateJobs(QVector<Job>)));
+
+    m_output.open(stdout, QIODevice::WriteOnly);
+}
+
+int HeadlessCollector::interval() const
+{
+    return m_timer->interval() / 1000;
+}
+
+void HeadlessCollector::setInterval(int seconds)
+{
+    m_timer->setInterval(qMax(1, seconds) * 1000);
+}
+
+bool HeadlessCollector::setOutputFileName(const QString &fileName)
+{
+    m_output.close();
+    if (fileName.isEmpty()) {
+        return m_output.open(stdout, QIODevice::WriteOnly);
+    }
+
+    m_output.setFileName(fileName);
+    if (!m_output.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Cannot write statistics to" << fileName << m_output.errorString();
+        return false;
+    }
+    return true;
+}
+
+QJsonObject HeadlessCollector::Counters::toJson() const
+{
+    QJsonObject object;
+    object.insert(QStringLiteral("finished"), double(finished));
+    object.insert(QStringLiteral("failed"), double(failed));
+    object.insert(QStringLiteral("local"), double(local));
+    object.insert(QStringLiteral("realMsec"), double(realMsec));
+    object.insert(QStringLiteral("inBytes"), double(inBytes));
+    object.insert(QStringLiteral("outBytes"), double(outBytes));
+    return object;
+}
+
+void HeadlessCollector::updateJobs(const QVector<Job> &jobs)
+{
+    foreach(const Job &job, jobs) {
+        if (!job.isDone()) {
+            continue;
+        }
+
+        Counters *counters[] = { &m_interval, &m_total };
+        for (Counters *c : counters) {
+            if (job.state == Job::Failed) {
+                ++c->failed;
+                continue;
+            }
+            ++c->finished;
+            if (job.server == 0) {
+                ++c->local;
+            }
+            c->realMsec += job.real_msec;
+            c->inBytes += job.in_uncompressed;
+            c->outBytes += job.out_uncompressed;
+        }
+    }
+}
+
+void HeadlessCollector::writeReport()
+{
+    if (!m_monitor) {
+        return;
+    }
+
+    // make sure the latest transitions are accounted for
+    m_monitor->flushJobUpdates();
+
+    const HostInfoManager *manager = m_monitor->hostInfoManager();
+    int hosts = 0;
+    int maxJobs = 0;
+    const HostSnapshot hostSnapshot = manager->hosts();
+    for (HostSnapshot::ConstIterator it = hostSnapshot.constBegin(); it != hostSnapshot.constEnd(); ++it) {
+        if (!(*it)->isOffline()) {
+            ++hosts;
+            maxJobs += (*it)->maxJobs();
+        }
+    }
+
+    QJsonObject report;
+    report.insert(QStringLiteral("time"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    report.insert(QStringLiteral("scheduler"), manager->schedulerName());
+    report.insert(QStringLiteral("network"), manager->networkName());
+    report.insert(QStringLiteral("online"), m_monitor->schedulerState() == Monitor::Online);
+    report.insert(QStringLiteral("hosts"), hosts);
+    report.insert(QStringLiteral("maxJobs"), maxJobs);
+    report.insert(QStringLiteral("activeJobs"), m_monitor->activeJobs().size());
+    report.insert(QStringLiteral("interval"), m_interval.toJson());
+    report.insert(QStringLiteral("total"), m_total.toJson());
+
+    m_output.write(QJsonDocument(report).toJson(QJsonDocument::Compact));
+    m_output.write("\n", 1);
+    m_output.flush();
+
+    m_interval = Counters();
+}
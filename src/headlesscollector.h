@@ -0,0 +1,97 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_HEADLESSCOLLECTOR_H
+#define ICEMON_HEADLESSCOLLECTOR_H
+
+#include "job.h"
+
+#include <QFile>
+#include <QJsonObject>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+class Monitor;
+
+class QTimer;
+
+/**
+ * Aggregates job statistics without any user interface
+ *
+ * Every interval one JSON object per line is appended to the output file
+ * (or written to stdout), containing the counters for that interval and
+ * the totals since the collector was started.
+ */
+class HeadlessCollector
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessCollector(Monitor *monitor, QObject *parent = nullptr);
+
+    /// Interval in seconds between two reports, default is 60
+    int interval() const;
+    void setInterval(int seconds);
+
+    /**
+     * Append reports to @p fileName, an empty name writes to stdout
+     *
+     * @return false if the file could not be opened
+     */
+    bool setOutputFileName(const QString &fileName);
+
+public Q_SLOTS:
+    void writeReport();
+
+private Q_SLOTS:
+    void updateJobs(const QVector<Job> &jobs);
+
+private:
+    struct Counters
+    {
+        Counters()
+            : finished(0)
+            , failed(0)
+            , local(0)
+            , realMsec(0)
+            , inBytes(0)
+            , outBytes(0) {}
+
+        QJsonObject toJson() const;
+
+        qint64 finished;
+        qint64 failed;
+        qint64 local;
+        qint64 realMsec;
+        qint64 inBytes;
+        qint64 outBytes;
+    };
+
+    QPointer<Monitor> m_monitor;
+    QTimer *m_timer;
+    QFile m_output;
+
+    Counters m_interval;
+    Counters m_total;
+};
+
+#endif // ICEMON_HEADLESSCOLLECTOR_H
@@ -0,0 +1,75 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "hostfilter.h"
+
+#include <QStringList>
+
+namespace {
+
+const QString HOST_PREFIX = QStringLiteral("host:");
+const QString PLATFORM_PREFIX = QStringLiteral("platform:");
+
+QRegularExpression compile(const QString &pattern)
+{
+    QRegularExpression expression(pattern);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+    // the filter is matched far more often than it is changed
+    expression.optimize();
+#endif
+    return expression;
+}
+
+}
+
+HostFilter::HostFilter()
+{
+}
+
+HostFilter::HostFilter(const QString &pattern)
+    : m_pattern(pattern)
+{
+    const QStringList terms = pattern.split(QRegularExpression(QStringLiteral("\\s+")), QString::SkipEmptyParts);
+    foreach (const QString &term, terms) {
+        if (term.startsWith(HOST_PREFIX)) {
+            m_hosts.append(compile(term.mid(HOST_PREFIX.length())));
+        } else if (term.startsWith(PLATFORM_PREFIX)) {
+            m_platforms.append(compile(term.mid(PLATFORM_PREFIX.length())));
+        } else {
+            m_platforms.append(compile(term));
+        }
+    }
+}
+
+bool HostFilter::matches(const QString &name, const QString &platform) const
+{
+    return (m_platforms.isEmpty() || matchesAny(m_platforms, platform))
+           && (m_hosts.isEmpty() || matchesAny(m_hosts, name));
+}
+
+bool HostFilter::matchesAny(const QVector<QRegularExpression> &expressions, const QString &text)
+{
+    foreach (const QRegularExpression &expression, expressions) {
+        if (expression.isValid() && expression.match(text).hasMatch()) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,59 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_HOSTFILTER_H
+#define ICEMON_HOSTFILTER_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+
+/**
+ * Compiled filter on the platform and name of hosts
+ *
+ * The pattern is a whitespace separated list of regular expressions. Terms
+ * prefixed with "host:" are matched against the host name, all others (or
+ * those prefixed with "platform:") against the platform. A host passes if it
+ * matches any of the platform terms and any of the host terms; an empty
+ * list of either kind lets everything pass. A term that is not a valid
+ * regular expression matches nothing.
+ *
+ * The expressions are compiled once, when the filter is created.
+ */
+class HostFilter
+{
+public:
+    HostFilter();
+    explicit HostFilter(const QString &pattern);
+
+    QString pattern() const { return m_pattern; }
+    bool isEmpty() const { return m_platforms.isEmpty() && m_hosts.isEmpty(); }
+
+    bool matches(const QString &name, const QString &platform) const;
+
+private:
+    static bool matchesAny(const QVector<QRegularExpression> &expressions, const QString &text);
+
+    QString m_pattern;
+    QVector<QRegularExpression> m_platforms;
+    QVector<QRegularExpression> m_hosts;
+};
+
+#endif // ICEMON_HOSTFILTER_H
@@ -20,7 +20,7 @@
 
 #include "hostinfo.h"
 
-#include <QApplication>
+#include <QCoreApplication>
 
 #include <qdebug.h>
 
@@ -29,34 +29,34 @@ QMap<int, QString> HostInfo::mColorNameMap;
 
 void HostInfo::initColorTable()
 {
-    initColor(QStringLiteral("#A5080B"), QApplication::tr("cherry"));
-    initColor(QStringLiteral("#76d26f"), QApplication::tr("pistachio"));
-    initColor(QStringLiteral("#664a08"), QApplication::tr("chocolate"));
-    initColor(QStringLiteral("#4c9dff"), QApplication::tr("smurf"));
-    initColor(QStringLiteral("#6c2ca8"), QApplication::tr("blueberry"));
-    initColor(QStringLiteral("#fa8344"), QApplication::tr("orange"));
-    initColor(QStringLiteral("#55CFBD"), QApplication::tr("mint"));
-    initColor(QStringLiteral("#db1230"), QApplication::tr("strawberry"));
-    initColor(QStringLiteral("#a6ea5e"), QApplication::tr("apple"));
-    initColor(QStringLiteral("#D6A3D8"), QApplication::tr("bubblegum"));
-    initColor(QStringLiteral("#f2aa4d"), QApplication::tr("peach"));
-    initColor(QStringLiteral("#aa1387"), QApplication::tr("plum"));
-    initColor(QStringLiteral("#26c3f7"), QApplication::tr("polar sea"));
-    initColor(QStringLiteral("#b8850e"), QApplication::tr("nut"));
-    initColor(QStringLiteral("#6a188d"), QApplication::tr("blackberry"));
-    initColor(QStringLiteral("#24b063"), QApplication::tr("woodruff"));
-    initColor(QStringLiteral("#ffff0f"), QApplication::tr("banana"));
-    initColor(QStringLiteral("#1e1407"), QApplication::tr("mocha"));
-    initColor(QStringLiteral("#29B450"), QApplication::tr("kiwi"));
-    initColor(QStringLiteral("#F8DD31"), QApplication::tr("lemon"));
-    initColor(QStringLiteral("#fa7e91"), QApplication::tr("raspberry"));
-    initColor(QStringLiteral("#c5a243"), QApplication::tr("caramel"));
-    initColor(QStringLiteral("#b8bcff"), QApplication::tr("blueberry"));
+    initColor(QStringLiteral("#A5080B"), QCoreApplication::translate("HostInfo", "cherry"));
+    initColor(QStringLiteral("#76d26f"), QCoreApplication::translate("HostInfo", "pistachio"));
+    initColor(QStringLiteral("#664a08"), QCoreApplication::translate("HostInfo", "chocolate"));
+    initColor(QStringLiteral("#4c9dff"), QCoreApplication::translate("HostInfo", "smurf"));
+    initColor(QStringLiteral("#6c2ca8"), QCoreApplication::translate("HostInfo", "blueberry"));
+    initColor(QStringLiteral("#fa8344"), QCoreApplication::translate("HostInfo", "orange"));
+    initColor(QStringLiteral("#55CFBD"), QCoreApplication::translate("HostInfo", "mint"));
+    initColor(QStringLiteral("#db1230"), QCoreApplication::translate("HostInfo", "strawberry"));
+    initColor(QStringLiteral("#a6ea5e"), QCoreApplication::translate("HostInfo", "apple"));
+    initColor(QStringLiteral("#D6A3D8"), QCoreApplication::translate("HostInfo", "bubblegum"));
+    initColor(QStringLiteral("#f2aa4d"), QCoreApplication::translate("HostInfo", "peach"));
+    initColor(QStringLiteral("#aa1387"), QCoreApplication::translate("HostInfo", "plum"));
+    initColor(QStringLiteral("#26c3f7"), QCoreApplication::translate("HostInfo", "polar sea"));
+    initColor(QStringLiteral("#b8850e"), QCoreApplication::translate("HostInfo", "nut"));
+    initColor(QStringLiteral("#6a188d"), QCoreApplication::translate("HostInfo", "blackberry"));
+    initColor(QStringLiteral("#24b063"), QCoreApplication::translate("HostInfo", "woodruff"));
+    initColor(QStringLiteral("#ffff0f"), QCoreApplication::translate("HostInfo", "banana"));
+    initColor(QStringLiteral("#1e1407"), QCoreApplication::translate("HostInfo", "mocha"));
+    initColor(QStringLiteral("#29B450"), QCoreApplication::translate("HostInfo", "kiwi"));
+    initColor(QStringLiteral("#F8DD31"), QCoreApplication::translate("HostInfo", "lemon"));
+    initColor(QStringLiteral("#fa7e91"), QCoreApplication::translate("HostInfo", "raspberry"));
+    initColor(QStringLiteral("#c5a243"), QCoreApplication::translate("HostInfo", "caramel"));
+    initColor(QStringLiteral("#b8bcff"), QCoreApplication::translate("HostInfo", "blueberry"));
     // try to make the count a prime number (reminder: 19, 23, 29, 31)
-    // initColor( "#ffb8c0", QApplication::tr("blackcurrant"));
-    // initColor( "#f7d36f", QApplication::tr("passionfruit"));
-    // initColor( "#d51013", QApplication::tr("pomegranate"));
-    // initColor( "#C2C032", QApplication::tr("pumpkin" ) );
+    // initColor( "#ffb8c0", QCoreApplication::translate("HostInfo", "blackcurrant"));
+    // initColor( "#f7d36f", QCoreApplication::translate("HostInfo", "passionfruit"));
+    // initColor( "#d51013", QCoreApplication::translate("HostInfo", "pomegranate"));
+    // initColor( "#C2C032", QCoreApplication::translate("HostInfo", "pumpkin" ) );
 }
 
 void HostInfo::initColor(const QString &value, const QString &name)
@@ -73,17 +73,22 @@ QString HostInfo::colorName(const QColor &c)
 {
     int key = c.red() + c.green() * 256 + c.blue() * 65536;
 
-    return mColorNameMap.value(key, QApplication::tr("<unknown>"));
+    return mColorNameMap.value(key, QCoreApplication::translate("HostInfo", "<unknown>"));
 }
 
 HostInfo::HostInfo(unsigned int id)
     : mId(id)
+    , mMaxJobs(0)
+    , mOffline(false)
+    , mNoRemote(false)
+    , mServerSpeed(0)
+    , mServerLoad(0)
 {
 }
 
 QString HostInfo::toolTip() const
 {
-    return QApplication::translate(("tooltip"),
+    return QCoreApplication::translate(("tooltip"),
                                    "<h3><b>%1</b></h3>"
                                    "<table>"
                                    "<tr><td>IP:</td><td>%2</td></tr>"
@@ -99,24 +104,58 @@ QString HostInfo::toolTip() const
            .arg(QString::number(serverSpeed()));
 }
 
-void HostInfo::updateFromStatsMap(const StatsMap &stats)
+HostInfo::Fields HostInfo::updateFromStats(const HostStats &stats)
 {
-    QString name = stats[QStringLiteral("Name")];
+    Fields fields;
 
-    if (name != mName) {
-        mName = name;
-        mColor = createColor(mName);
-        mIp = stats[QStringLiteral("IP")];
-        mPlatform = stats[QStringLiteral("Platform")];
-    }
+    if (!stats.textEquals(HostStats::Name, mName)) {
+        mName = stats.text(HostStats::Name);
+        fields |= NameField;
 
-    mNoRemote = (stats[QStringLiteral("NoRemote")].compare(QLatin1String("true"), Qt::CaseInsensitive) == 0);
-    mMaxJobs = stats[QStringLiteral("MaxJobs")].toUInt();
-    mOffline = (stats[QStringLiteral("State")] == QLatin1String("Offline"));
+        const QColor color = createColor(mName);
+        if (color != mColor) {
+            mColor = color;
+            fields |= ColorField;
+        }
+        const QString ip = stats.text(HostStats::IP);
+        if (ip != mIp) {
+            mIp = ip;
+            fields |= IpField;
+        }
+        const QString platform = stats.text(HostStats::Platform);
+        if (platform != mPlatform) {
+            mPlatform = platform;
+            fields |= PlatformField;
+        }
+    }
 
-    mServerSpeed = stats[QStringLiteral("Speed")].toFloat();
+    const bool noRemote = stats.noRemote();
+    if (noRemote != mNoRemote) {
+        mNoRemote = noRemote;
+        fields |= NoRemoteField;
+    }
+    const unsigned int maxJobs = stats.maxJobs();
+    if (maxJobs != mMaxJobs) {
+        mMaxJobs = maxJobs;
+        fields |= MaxJobsField;
+    }
+    const bool offline = stats.isOffline();
+    if (offline != mOffline) {
+        mOffline = offline;
+        fields |= OfflineField;
+    }
+    const float speed = stats.speed();
+    if (speed != mServerSpeed) {
+        mServerSpeed = speed;
+        fields |= SpeedField;
+    }
+    const unsigned int load = stats.load();
+    if (load != mServerLoad) {
+        mServerLoad = load;
+        fields |= LoadField;
+    }
 
-    mServerLoad = stats[QStringLiteral("Load")].toUInt();
+    return fields;
 }
 
 QColor HostInfo::createColor(const QString &name)
@@ -149,7 +188,19 @@ QColor HostInfo::createColor()
     return mColorTable.at(num++ % mColorTable.count());
 }
 
+HostSnapshot::HostSnapshot()
+    : d(new Data)
+{
+}
+
+HostInfo *HostSnapshot::find(HostId id) const
+{
+    const int i = indexOf(id);
+    return (i >= 0 ? d->hosts.at(i) : nullptr);
+}
+
 HostInfoManager::HostInfoManager()
+    : mVersion(0)
 {
     HostInfo::initColorTable();
 }
@@ -170,26 +221,36 @@ void HostInfoManager::checkNode(const HostInfo &info)
     if (it == mHostMap.constEnd()) {
         auto hostInfo = new HostInfo(info);
         mHostMap.insert(info.id(), hostInfo);
+        ++mVersion;
         emit hostMapChanged();
+        emit hostChanged(info.id(), HostInfo::AllFields);
     } else {
         // no-op
     }
 }
 
 HostInfo *HostInfoManager::checkNode(unsigned int hostid,
-                                     const HostInfo::StatsMap &stats)
+                                     const HostStats &stats)
 {
     HostMap::ConstIterator it = mHostMap.constFind(hostid);
     HostInfo *hostInfo;
+    HostInfo::Fields fields;
     if (it == mHostMap.constEnd()) {
         hostInfo = new HostInfo(hostid);
         mHostMap.insert(hostid, hostInfo);
+        ++mVersion;
+        fields = HostInfo::AllFields;
     } else {
         hostInfo = *it;
     }
 
-    hostInfo->updateFromStatsMap(stats);
-    emit hostMapChanged();
+    fields |= hostInfo->updateFromStats(stats);
+    if (fields & HostInfo::AddedField) {
+        emit hostMapChanged();
+    }
+    if (fields) {
+        emit hostChanged(hostid, fields);
+    }
 
     return hostInfo;
 }
@@ -201,7 +262,7 @@ QString HostInfoManager::nameForHost(unsigned int id) const
         return hostInfo->name();
     }
 
-    return QApplication::tr("<unknown>");
+    return QCoreApplication::translate("HostInfo", "<unknown>");
 }
 
 QColor HostInfoManager::hostColor(unsigned int id) const
@@ -233,9 +294,20 @@ unsigned int HostInfoManager::maxJobs(unsigned int id) const
     return 0;
 }
 
-HostInfoManager::HostMap HostInfoManager::hostMap() const
+HostSnapshot HostInfoManager::hosts() const
 {
-    return mHostMap;
+    if (mSnapshot.version() != mVersion) {
+        QSharedPointer<HostSnapshot::Data> data(new HostSnapshot::Data);
+        data->version = mVersion;
+        data->hosts.reserve(mHostMap.size());
+        data->index.reserve(mHostMap.size());
+        for (HostMap::ConstIterator it = mHostMap.constBegin(); it != mHostMap.constEnd(); ++it) {
+            data->index.insert(it.key(), data->hosts.size());
+            data->hosts.append(*it);
+        }
+        mSnapshot = HostSnapshot(data);
+    }
+    return mSnapshot;
 }
 
 void HostInfoManager::setSchedulerName(const QString &schedulerName)
@@ -20,15 +20,37 @@
 #ifndef ICEMON_HOSTINFO_H
 #define ICEMON_HOSTINFO_H
 
+#include "hoststats.h"
+#include "types.h"
+
 #include <QString>
 #include <QColor>
+#include <QHash>
 #include <QMap>
 #include <QObject>
+#include <QSharedPointer>
 #include <QtCore/QVector>
 
 class HostInfo
 {
 public:
+    /// Observable properties, used to tell consumers what changed
+    enum Field {
+        NameField = 0x1,
+        ColorField = 0x2,
+        IpField = 0x4,
+        PlatformField = 0x8,
+        MaxJobsField = 0x10,
+        OfflineField = 0x20,
+        NoRemoteField = 0x40,
+        SpeedField = 0x80,
+        LoadField = 0x100,
+        /// The host was not known before
+        AddedField = 0x200,
+        AllFields = 0x3ff
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+
     explicit HostInfo(unsigned int id = 0);
 
     unsigned int id() const { return mId; }
@@ -54,8 +76,8 @@ public:
     void setNoRemote(bool noRemote) { mNoRemote = noRemote; }
     bool noRemote() const { return mNoRemote; }
 
-    typedef QMap<QString, QString> StatsMap;
-    void updateFromStatsMap(const StatsMap &stats);
+    /// @return the fields whose value differs from before
+    Fields updateFromStats(const HostStats &stats);
 
     static void initColorTable();
     static QString colorName(const QColor &);
@@ -100,6 +122,58 @@ private:
     static QMap<int, QString> mColorNameMap;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(HostInfo::Fields)
+
+/**
+ * Immutable view of the known hosts, sorted by id
+ *
+ * Copying a snapshot only bumps a reference count, so readers can hold on
+ * to one instead of copying the host map. The HostInfo objects themselves
+ * are live and keep being updated, only the membership is frozen; hosts are
+ * never deleted while their manager exists.
+ */
+class HostSnapshot
+{
+public:
+    typedef QVector<HostInfo *>::const_iterator const_iterator;
+    typedef const_iterator ConstIterator;
+
+    HostSnapshot();
+
+    /// Changes whenever hosts are added to the manager
+    quint64 version() const { return d->version; }
+
+    bool isEmpty() const { return d->hosts.isEmpty(); }
+    int size() const { return d->hosts.size(); }
+    HostInfo *at(int i) const { return d->hosts.at(i); }
+    /// @return the index of @p id, or -1 if it is not part of this snapshot
+    int indexOf(HostId id) const { return d->index.value(id, -1); }
+    HostInfo *find(HostId id) const;
+
+    const_iterator begin() const { return d->hosts.constBegin(); }
+    const_iterator end() const { return d->hosts.constEnd(); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+private:
+    friend class HostInfoManager;
+
+    struct Data
+    {
+        Data()
+            : version(0) {}
+
+        quint64 version;
+        QVector<HostInfo *> hosts;
+        QHash<HostId, int> index;
+    };
+
+    explicit HostSnapshot(const QSharedPointer<const Data> &data)
+        : d(data) {}
+
+    QSharedPointer<const Data> d;
+};
+
 class HostInfoManager
     : public QObject
 {
@@ -111,13 +185,12 @@ public:
 
     HostInfo *find(unsigned int hostid) const;
 
-    typedef QMap<unsigned int, HostInfo *> HostMap;
-
-    HostMap hostMap() const;
+    /// Cheap to call, only rebuilt after hosts were added
+    HostSnapshot hosts() const;
 
     void checkNode(const HostInfo &info);
     HostInfo *checkNode(unsigned int hostid,
-                        const HostInfo::StatsMap &statmsg);
+                        const HostStats &stats);
 
     QString nameForHost(unsigned int id) const;
     QColor hostColor(unsigned int id) const;
@@ -129,10 +202,22 @@ public:
     void setNetworkName(const QString &networkName);
 
 signals:
+    /// Emitted when a host is added to the map
     void hostMapChanged();
+    /**
+     * Emitted when a stats message changed at least one field of @p hostid
+     *
+     * Stats messages that repeat the known values do not emit anything,
+     * use Monitor::nodeUpdated() to learn that a host is still alive.
+     */
+    void hostChanged(HostId hostid, HostInfo::Fields fields);
 
 private:
+    typedef QMap<unsigned int, HostInfo *> HostMap;
+
     HostMap mHostMap;
+    quint64 mVersion;
+    mutable HostSnapshot mSnapshot;
     QString mSchedulerName;
     QString mNetworkName;
 };
@@ -0,0 +1,183 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "hoststats.h"
+
+#include <string.h>
+
+namespace {
+
+struct KeyName
+{
+    const char *name;
+    int length;
+};
+
+const KeyName KEY_NAMES[HostStats::KeyCount] = {
+    { "Name", 4 },
+    { "IP", 2 },
+    { "Platform", 8 },
+    { "MaxJobs", 7 },
+    { "Load", 4 },
+    { "Speed", 5 },
+    { "State", 5 },
+    { "NoRemote", 8 }
+};
+
+unsigned int parseUInt(const char *data, int length)
+{
+    unsigned int value = 0;
+    for (int i = 0; i < length; ++i) {
+        if (data[i] < '0' || data[i] > '9') {
+            // same as QString::toUInt(), anything malformed is 0
+            return 0;
+        }
+        value = value * 10 + unsigned(data[i] - '0');
+    }
+    return value;
+}
+
+/// Locale independent, daemons always send "123.456"
+float parseFloat(const char *data, int length)
+{
+    double value = 0;
+    double scale = 0;
+    bool negative = false;
+    for (int i = 0; i < length; ++i) {
+        const char c = data[i];
+        if (c >= '0' && c <= '9') {
+            if (scale > 0) {
+                value += (c - '0') * scale;
+                scale /= 10;
+            } else {
+                value = value * 10 + (c - '0');
+            }
+        } else if (c == '.' && scale == 0) {
+            scale = 0.1;
+        } else if (c == '-' && i == 0) {
+            negative = true;
+        } else {
+            return 0;
+        }
+    }
+    return float(negative ? -value : value);
+}
+
+bool isAscii(const char *data, int length)
+{
+    for (int i = 0; i < length; ++i) {
+        if (uchar(data[i]) >= 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+HostStats::HostStats()
+    : m_present(0)
+    , m_maxJobs(0)
+    , m_load(0)
+    , m_speed(0)
+    , m_offline(false)
+    , m_noRemote(false)
+{
+    memset(m_spans, 0, sizeof(m_spans));
+}
+
+HostStats::HostStats(const QByteArray &message)
+    : m_message(message)
+    , m_present(0)
+    , m_maxJobs(0)
+    , m_load(0)
+    , m_speed(0)
+    , m_offline(false)
+    , m_noRemote(false)
+{
+    memset(m_spans, 0, sizeof(m_spans));
+    parse();
+}
+
+void HostStats::parse()
+{
+    const char *begin = m_message.constData();
+    const char *end = begin + m_message.size();
+
+    for (const char *line = begin; line < end;) {
+        const char *lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char *colon = static_cast<const char *>(memchr(line, ':', lineEnd - line));
+        if (colon) {
+            const int keyLength = int(colon - line);
+            for (int key = 0; key < KeyCount; ++key) {
+                if (KEY_NAMES[key].length == keyLength && memcmp(KEY_NAMES[key].name, line, keyLength) == 0) {
+                    m_spans[key].offset = int(colon + 1 - begin);
+                    m_spans[key].length = int(lineEnd - colon - 1);
+                    m_present |= (1u << key);
+                    break;
+                }
+            }
+        }
+        line = lineEnd + 1;
+    }
+
+    m_maxJobs = parseUInt(data(MaxJobs), m_spans[MaxJobs].length);
+    m_load = parseUInt(data(Load), m_spans[Load].length);
+    m_speed = parseFloat(data(Speed), m_spans[Speed].length);
+    m_offline = (m_spans[State].length == 7 && memcmp(data(State), "Offline", 7) == 0);
+    m_noRemote = (m_spans[NoRemote].length == 4 && qstrnicmp(data(NoRemote), "true", 4) == 0);
+}
+
+QString HostStats::text(Key key) const
+{
+    return QString::fromUtf8(data(key), m_spans[key].length);
+}
+
+bool HostStats::textEquals(Key key, const QString &text) const
+{
+    const int length = m_spans[key].length;
+    if (isAscii(data(key), length)) {
+        return text == QLatin1String(data(key), length);
+    }
+    return text == this->text(key);
+}
+
+QString HostStats::value(const QString &key) const
+{
+    const QByteArray name = key.toUtf8();
+
+    const char *begin = m_message.constData();
+    const char *end = begin + m_message.size();
+    for (const char *line = begin; line < end;) {
+        const char *lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        const char *colon = static_cast<const char *>(memchr(line, ':', lineEnd - line));
+        if (colon && colon - line == name.size() && memcmp(line, name.constData(), name.size()) == 0) {
+            return QString::fromUtf8(colon + 1, int(lineEnd - colon - 1));
+        }
+        line = lineEnd + 1;
+    }
+    return QString();
+}
@@ -0,0 +1,92 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_HOSTSTATS_H
+#define ICEMON_HOSTSTATS_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * Host statistics as sent by a daemon via the scheduler
+ *
+ * The message consists of "Key:Value" lines. It is parsed in a single pass
+ * without copying: the known keys are converted into typed values right
+ * away, text values and unknown keys are only materialized on request.
+ */
+class HostStats
+{
+public:
+    enum Key {
+        Name,
+        IP,
+        Platform,
+        MaxJobs,
+        Load,
+        Speed,
+        State,
+        NoRemote,
+        KeyCount
+    };
+
+    HostStats();
+    explicit HostStats(const QByteArray &message);
+
+    bool contains(Key key) const { return m_present & (1u << key); }
+
+    /// Text value of a known key, empty if not present
+    QString text(Key key) const;
+    /// Compares without allocating as long as the value is plain ASCII
+    bool textEquals(Key key, const QString &text) const;
+
+    unsigned int maxJobs() const { return m_maxJobs; }
+    unsigned int load() const { return m_load; }
+    float speed() const { return m_speed; }
+    bool isOffline() const { return m_offline; }
+    bool noRemote() const { return m_noRemote; }
+
+    /// Value of an arbitrary, possibly unknown key
+    QString value(const QString &key) const;
+
+    /// The unparsed message
+    QByteArray message() const { return m_message; }
+
+private:
+    struct Span
+    {
+        int offset;
+        int length;
+    };
+
+    void parse();
+    const char *data(Key key) const { return m_message.constData() + m_spans[key].offset; }
+
+    QByteArray m_message;
+    Span m_spans[KeyCount];
+    quint32 m_present;
+
+    unsigned int m_maxJobs;
+    unsigned int m_load;
+    float m_speed;
+    bool m_offline;
+    bool m_noRemote;
+};
+
+#endif // ICEMON_HOSTSTATS_H
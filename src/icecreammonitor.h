@@ -23,19 +23,22 @@
 #ifndef ICEMON_ICECREAMMONITOR_H
 #define ICEMON_ICECREAMMONITOR_H
 
-#include "monitor.h"
-
-#include <QtCore/QSocketNotifier>
+#include "eventmonitor.h"
 
 class HostInfoManager;
-class Msg;
-class MsgChannel;
-class StatusView;
-class DiscoverSched;
-class QSocketNotifier;
+class SchedulerConnection;
+
+class QThread;
 
+/**
+ * Monitor for a real icecream scheduler
+ *
+ * Talking to the scheduler happens in a SchedulerConnection living in its
+ * own thread; this class only applies the decoded events on the GUI thread,
+ * in bounded slices so that painting never starves.
+ */
 class IcecreamMonitor
-    : public Monitor
+    : public EventMonitor
 {
     Q_OBJECT
 
@@ -43,31 +46,17 @@ public:
     IcecreamMonitor(HostInfoManager *, QObject *parent);
     ~IcecreamMonitor();
 
-    virtual QList<Job> jobHistory() const override;
+    virtual void setCurrentNetname(const QByteArray &netname) override;
+    virtual void setCurrentSchedname(const QByteArray &schedname) override;
 
 private slots:
-    void slotCheckScheduler();
-    void msgReceived();
+    void processEvents();
 
 private:
-    void checkScheduler(bool deleteit = false);
-    void registerNotify(int fd, QSocketNotifier::Type type, const char *slot);
     void setupDebug();
 
-    bool handle_activity();
-    void handle_getcs(Msg *m);
-    void handle_job_begin(Msg *m);
-    void handle_job_done(Msg *m);
-    void handle_stats(Msg *m);
-    void handle_local_begin(Msg *m);
-    void handle_local_done(Msg *m);
-
-    JobList m_rememberedJobs;
-    MsgChannel *m_scheduler;
-
-    DiscoverSched *m_discover;
-    QSocketNotifier *m_fd_notify;
-    QSocketNotifier::Type m_fd_type;
+    QThread *m_thread;
+    SchedulerConnection *m_connection;
 };
 
 #endif // ICEMON_ICECREAMMONITOR_H
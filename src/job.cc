@@ -23,15 +23,16 @@
 #include "job.h"
 
 #include <QObject>
-#include <QApplication>
+#include <QCoreApplication>
 
-Job::Job(unsigned int id, unsigned int client, const QString &filename, const QString &lang)
+static_assert(sizeof(Job) <= 64, "Job is copied by value everywhere, keep it compact");
+
+Job::Job(unsigned int id, unsigned int client, const QString &filename, Language lang)
     : id(id)
-    , fileName(filename)
+    , fileId(PathTable::intern(filename))
     , server(0)
     , client(client)
-    , lang(lang)
-    , state(WaitingForCS)
+    , startTime(0)
     , real_msec(0)
     , user_msec(0)
     , sys_msec(0)
@@ -41,6 +42,8 @@ Job::Job(unsigned int id, unsigned int client, const QString &filename, const QS
     , in_uncompressed(0)
     , out_compressed(0)
     , out_uncompressed(0)
+    , lang(lang)
+    , state(WaitingForCS)
 {
 }
 
@@ -48,22 +51,22 @@ QString Job::stateAsString() const
 {
     switch (state) {
     case WaitingForCS:
-        return QApplication::tr("Waiting");
+        return QCoreApplication::translate("Job", "Waiting");
         break;
     case Compiling:
-        return QApplication::tr("Compiling");
+        return QCoreApplication::translate("Job", "Compiling");
         break;
     case Finished:
-        return QApplication::tr("Finished");
+        return QCoreApplication::translate("Job", "Finished");
         break;
     case Failed:
-        return QApplication::tr("Failed");
+        return QCoreApplication::translate("Job", "Failed");
         break;
     case Idle:
-        return QApplication::tr("Idle");
+        return QCoreApplication::translate("Job", "Idle");
         break;
     case LocalOnly:
-        return QApplication::tr("Local Only");
+        return QCoreApplication::translate("Job", "Local Only");
         break;
     }
     return QString();
@@ -74,7 +77,7 @@ QDebug operator<<(QDebug dbg, const Job &job)
     return dbg.nospace() << "Job[id=" << job.id
            << ", client=" << job.client
            << ", server=" << job.server
-           << ", fileName=" << job.fileName
+           << ", fileName=" << job.fileName()
            << ", state=" << job.stateAsString()
            << "]";
 }
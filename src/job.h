@@ -22,35 +22,44 @@
 #ifndef ICEMON_JOB_H
 #define ICEMON_JOB_H
 
+#include "pathtable.h"
+
 #include <QString>
 #include <time.h>
 #include <QMap>
 #include <qdebug.h>
 
+/**
+ * Compact, trivially copyable job record
+ *
+ * The file name is interned in the PathTable, so copying a Job through
+ * signals and containers never touches reference counts.
+ */
 class Job
 {
 public:
-    enum State { WaitingForCS, LocalOnly, Compiling, Finished, Failed, Idle };
+    enum State : quint8 { WaitingForCS, LocalOnly, Compiling, Finished, Failed, Idle };
+    enum Language : quint8 { Lang_Unknown, Lang_C, Lang_CXX };
 
     explicit Job(unsigned int id = 0,
                  unsigned int client = 0,
                  const QString &filename = QString(),
-                 const QString &lang = QString());
+                 Language lang = Lang_Unknown);
 
     bool operator==(const Job &rhs) const { return id == rhs.id; }
     bool operator!=(const Job &rhs) const { return id != rhs.id; }
     int operator<(const Job &rhs) const { return id < rhs.id; }
 
+    QString fileName() const { return PathTable::path(fileId); }
+
     QString stateAsString() const;
     bool isDone() const { return state == Finished || state == Failed; }
     bool isActive() const { return state == LocalOnly || state == Compiling; }
 
     unsigned int id;
-    QString fileName;
+    PathTable::PathId fileId;
     unsigned int server;
     unsigned int client;
-    QString lang;
-    State state;
     time_t startTime;
 
     unsigned int real_msec;  /* real time it used */
@@ -64,7 +73,11 @@ public:
     unsigned int in_uncompressed;
     unsigned int out_compressed;
     unsigned int out_uncompressed;
+
+    Language lang;
+    State state;
 };
+Q_DECLARE_TYPEINFO(Job, Q_MOVABLE_TYPE);
 
 QDebug operator<<(QDebug dbg, const Job &job);
 
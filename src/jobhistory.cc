@@ -0,0 +1,164 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "jobhistory.h"
+
+#include <QDebug>
+#include <QSettings>
+
+JobHistory::JobHistory(int maxCount)
+    : m_first(0)
+    , m_count(0)
+    , m_maxCount(qMax(1, maxCount))
+    , m_maxBytes(0)
+    , m_spilledCount(0)
+{
+    m_spillStream.setVersion(QDataStream::Qt_5_2);
+}
+
+JobHistory::~JobHistory()
+{
+    setSpillFileName(QString());
+}
+
+void JobHistory::setMaxCount(int count)
+{
+    m_maxCount = qMax(1, count);
+    resize(capacity());
+}
+
+void JobHistory::setMaxBytes(qint64 bytes)
+{
+    m_maxBytes = qMax<qint64>(0, bytes);
+    resize(capacity());
+}
+
+int JobHistory::capacity() const
+{
+    if (m_maxBytes == 0) {
+        return m_maxCount;
+    }
+    const qint64 byteCapacity = qMax<qint64>(1, m_maxBytes / qint64(sizeof(Job)));
+    return int(qMin<qint64>(m_maxCount, byteCapacity));
+}
+
+QString JobHistory::spillFileName() const
+{
+    return m_spillFile.fileName();
+}
+
+bool JobHistory::setSpillFileName(const QString &fileName)
+{
+    if (m_spillFile.isOpen()) {
+        m_spillStream.setDevice(nullptr);
+        m_spillFile.close();
+    }
+    m_spillFile.setFileName(fileName);
+    if (fileName.isEmpty()) {
+        return true;
+    }
+
+    if (!m_spillFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Cannot open job history file" << fileName << m_spillFile.errorString();
+        return false;
+    }
+
+    m_spillStream.setDevice(&m_spillFile);
+    if (m_spillFile.size() == 0) {
+        m_spillStream << quint32(SpillFileMagic) << quint32(SpillFileVersion);
+    }
+    return true;
+}
+
+void JobHistory::readSettings()
+{
+    QSettings settings;
+    setMaxCount(settings.value(QStringLiteral("jobHistory/maxJobs"), int(DefaultMaxCount)).toInt());
+    setMaxBytes(settings.value(QStringLiteral("jobHistory/maxBytes"), 0).toLongLong());
+    setSpillFileName(settings.value(QStringLiteral("jobHistory/spillFile")).toString());
+}
+
+void JobHistory::append(const Job &job)
+{
+    const int cap = capacity();
+    if (m_count == cap) {
+        evictOldest();
+    }
+
+    if (m_ring.size() < cap && m_first == 0) {
+        // still growing towards the budget, the ring has not wrapped yet
+        m_ring.append(job);
+    } else {
+        m_ring[(m_first + m_count) % m_ring.size()] = job;
+    }
+    ++m_count;
+}
+
+void JobHistory::clear()
+{
+    if (m_spillFile.isOpen()) {
+        for (int i = 0; i < m_count; ++i) {
+            spill(at(i));
+        }
+    }
+    m_ring.clear();
+    m_first = 0;
+    m_count = 0;
+}
+
+void JobHistory::evictOldest()
+{
+    spill(m_ring.at(m_first));
+    m_first = (m_first + 1) % m_ring.size();
+    --m_count;
+}
+
+void JobHistory::resize(int capacity)
+{
+    while (m_count > capacity) {
+        evictOldest();
+    }
+
+    // linearize, so that the ring can grow again from the front
+    QVector<Job> jobs;
+    jobs.reserve(m_count);
+    for (int i = 0; i < m_count; ++i) {
+        jobs.append(at(i));
+    }
+    m_ring.swap(jobs);
+    m_first = 0;
+}
+
+void JobHistory::spill(const Job &job)
+{
+    if (!m_spillFile.isOpen()) {
+        return;
+    }
+
+    m_spillStream << quint32(job.id) << job.fileName()
+                  << quint32(job.server) << quint32(job.client)
+                  << qint64(job.startTime)
+                  << quint32(job.real_msec) << quint32(job.user_msec) << quint32(job.sys_msec)
+                  << quint32(job.pfaults) << qint32(job.exitcode)
+                  << quint32(job.in_compressed) << quint32(job.in_uncompressed)
+                  << quint32(job.out_compressed) << quint32(job.out_uncompressed)
+                  << quint8(job.lang) << quint8(job.state);
+    ++m_spilledCount;
+}
@@ -0,0 +1,150 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_JOBHISTORY_H
+#define ICEMON_JOBHISTORY_H
+
+#include "job.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QVector>
+
+#include <iterator>
+
+/**
+ * Append-only, memory-bounded ring of finished jobs
+ *
+ * Once the count or byte budget is exhausted the oldest job is evicted. If a
+ * spill file is set, evicted jobs are appended to it instead of being lost.
+ *
+ * The spill file is a QDataStream (Qt 5.2 format) starting with the magic
+ * number and version, followed by one record per job:
+ * id, file name, server, client, start time (qint64), real/user/sys msec,
+ * page faults, exit code, in/out compressed/uncompressed sizes, language,
+ * state (quint8 each).
+ */
+class JobHistory
+{
+public:
+    enum {
+        DefaultMaxCount = 100000,
+        SpillFileMagic = 0x4a484953, // "JHIS"
+        SpillFileVersion = 1
+    };
+
+    class const_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef Job value_type;
+        typedef const Job *pointer;
+        typedef const Job &reference;
+
+        const_iterator()
+            : m_history(nullptr)
+            , m_index(0) {}
+
+        const Job &operator*() const { return m_history->at(m_index); }
+        const Job *operator->() const { return &m_history->at(m_index); }
+        bool operator==(const const_iterator &other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator &other) const { return m_index != other.m_index; }
+        const_iterator &operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) { const_iterator it = *this; ++m_index; return it; }
+        const_iterator &operator--() { --m_index; return *this; }
+        const_iterator operator--(int) { const_iterator it = *this; --m_index; return it; }
+
+    private:
+        friend class JobHistory;
+        const_iterator(const JobHistory *history, int index)
+            : m_history(history)
+            , m_index(index) {}
+
+        const JobHistory *m_history;
+        int m_index;
+    };
+    typedef const_iterator ConstIterator;
+
+    explicit JobHistory(int maxCount = DefaultMaxCount);
+    ~JobHistory();
+
+    /// Maximum number of jobs kept in memory
+    int maxCount() const { return m_maxCount; }
+    void setMaxCount(int count);
+
+    /// Maximum memory used by the ring, 0 means no byte limit
+    qint64 maxBytes() const { return m_maxBytes; }
+    void setMaxBytes(qint64 bytes);
+
+    /// Effective number of jobs kept in memory given both budgets
+    int capacity() const;
+
+    QString spillFileName() const;
+    /**
+     * Append evicted jobs to @p fileName, an empty name disables spilling
+     *
+     * @return false if the file could not be opened
+     */
+    bool setSpillFileName(const QString &fileName);
+    /// Number of jobs written to the spill file during this session
+    qint64 spilledCount() const { return m_spilledCount; }
+
+    /**
+     * Apply the jobHistory/maxJobs, jobHistory/maxBytes and
+     * jobHistory/spillFile settings
+     */
+    void readSettings();
+
+    void append(const Job &job);
+    /// Drop all jobs, writing them to the spill file first if one is set
+    void clear();
+
+    bool isEmpty() const { return m_count == 0; }
+    int size() const { return m_count; }
+
+    /// @p i is 0 for the oldest job
+    const Job &at(int i) const { return m_ring.at((m_first + i) % m_ring.size()); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_count); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+private:
+    void evictOldest();
+    void resize(int capacity);
+    void spill(const Job &job);
+
+    QVector<Job> m_ring;
+    int m_first;
+    int m_count;
+
+    int m_maxCount;
+    qint64 m_maxBytes;
+
+    QFile m_spillFile;
+    QDataStream m_spillStream;
+    qint64 m_spilledCount;
+
+    Q_DISABLE_COPY(JobHistory)
+};
+
+#endif // ICEMON_JOBHISTORY_H
@@ -0,0 +1,177 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "jobstatistics.h"
+
+#include <QCoreApplication>
+#include <QLocale>
+#include <QStringList>
+
+#include <algorithm>
+
+namespace {
+
+const int DEFAULT_MAX_PATHS = 4096;
+
+QString formatDuration(quint64 msec)
+{
+    if (msec < 1000) {
+        return QCoreApplication::translate("JobStatistics", "%1 ms").arg(msec);
+    }
+    return QCoreApplication::translate("JobStatistics", "%1 s").arg(QLocale::system().toString(msec / 1000.0, 'f', 1));
+}
+
+QString formatSize(quint64 bytes)
+{
+    static const char *const units[] = { "B", "KiB", "MiB", "GiB" };
+    double value = bytes;
+    int unit = 0;
+    while (unit < 3 && value >= 1024) {
+        value /= 1024;
+        ++unit;
+    }
+    return QCoreApplication::translate("JobStatistics", "%1 %2")
+           .arg(QLocale::system().toString(value, 'f', unit ? 1 : 0), QLatin1String(units[unit]));
+}
+
+QString summary(const LogHistogram &histogram, QString (*format)(quint64), const QString &separator)
+{
+    if (histogram.isEmpty()) {
+        return QCoreApplication::translate("JobStatistics", "n/a");
+    }
+    return QStringList({
+        QCoreApplication::translate("JobStatistics", "p50 %1").arg(format(histogram.percentile(50))),
+        QCoreApplication::translate("JobStatistics", "p90 %1").arg(format(histogram.percentile(90))),
+        QCoreApplication::translate("JobStatistics", "p99 %1").arg(format(histogram.percentile(99))),
+        QCoreApplication::translate("JobStatistics", "max %1").arg(format(histogram.max()))
+    }).join(separator);
+}
+
+}
+
+void JobStatistics::Histograms::record(const Job &job)
+{
+    realTime.record(job.real_msec);
+    userTime.record(job.user_msec);
+    inBytes.record(job.in_uncompressed);
+    outBytes.record(job.out_uncompressed);
+}
+
+void JobStatistics::Histograms::merge(const Histograms &other)
+{
+    realTime.merge(other.realTime);
+    userTime.merge(other.userTime);
+    inBytes.merge(other.inBytes);
+    outBytes.merge(other.outBytes);
+}
+
+JobStatistics::JobStatistics()
+    : m_maxPaths(DEFAULT_MAX_PATHS)
+    , m_tick(0)
+{
+}
+
+void JobStatistics::setMaxPaths(int count)
+{
+    m_maxPaths = qMax(1, count);
+    if (m_paths.size() > m_maxPaths) {
+        evictPaths();
+    }
+}
+
+void JobStatistics::record(const Job &job)
+{
+    // local jobs carry no timing or size data, they would only add zeros
+    if (job.state != Job::Finished || job.server == 0) {
+        return;
+    }
+
+    m_total.record(job);
+    m_servers[job.server].record(job);
+    if (job.client) {
+        m_clients[job.client].record(job);
+    }
+    if (job.fileId) {
+        PathHistograms &path = m_paths[job.fileId];
+        path.histograms.record(job);
+        path.lastUsed = ++m_tick;
+        if (m_paths.size() > m_maxPaths) {
+            evictPaths();
+        }
+    }
+}
+
+void JobStatistics::clear()
+{
+    m_total = Histograms();
+    m_servers.clear();
+    m_clients.clear();
+    m_paths.clear();
+}
+
+void JobStatistics::evictPaths()
+{
+    // drop the least recently used quarter, so this happens rarely
+    QVector<quint64> ages;
+    ages.reserve(m_paths.size());
+    for (QHash<PathTable::PathId, PathHistograms>::ConstIterator it = m_paths.constBegin();
+         it != m_paths.constEnd(); ++it) {
+        ages.append((*it).lastUsed);
+    }
+    const int keep = m_maxPaths - m_maxPaths / 4;
+    QVector<quint64>::iterator cutoff = ages.begin() + (ages.size() - keep);
+    std::nth_element(ages.begin(), cutoff, ages.end());
+
+    for (QHash<PathTable::PathId, PathHistograms>::Iterator it = m_paths.begin(); it != m_paths.end();) {
+        if ((*it).lastUsed < *cutoff) {
+            it = m_paths.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+const JobStatistics::Histograms *JobStatistics::server(HostId id) const
+{
+    QHash<HostId, Histograms>::ConstIterator it = m_servers.constFind(id);
+    return (it != m_servers.constEnd() ? &(*it) : nullptr);
+}
+
+const JobStatistics::Histograms *JobStatistics::client(HostId id) const
+{
+    QHash<HostId, Histograms>::ConstIterator it = m_clients.constFind(id);
+    return (it != m_clients.constEnd() ? &(*it) : nullptr);
+}
+
+const JobStatistics::Histograms *JobStatistics::path(PathTable::PathId id) const
+{
+    QHash<PathTable::PathId, PathHistograms>::ConstIterator it = m_paths.constFind(id);
+    return (it != m_paths.constEnd() ? &(*it).histograms : nullptr);
+}
+
+QString JobStatistics::durationSummary(const LogHistogram &histogram, const QString &separator)
+{
+    return summary(histogram, formatDuration, separator);
+}
+
+QString JobStatistics::sizeSummary(const LogHistogram &histogram, const QString &separator)
+{
+    return summary(histogram, formatSize, separator);
+}
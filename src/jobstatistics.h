@@ -0,0 +1,94 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_JOBSTATISTICS_H
+#define ICEMON_JOBSTATISTICS_H
+
+#include "job.h"
+#include "loghistogram.h"
+#include "pathtable.h"
+#include "types.h"
+
+#include <QHash>
+
+/**
+ * Percentile statistics of finished remote jobs
+ *
+ * Maintained per server host, per client host and per source path. Paths
+ * are limited to maxPaths(); when exceeded, the least recently compiled
+ * quarter of them is dropped.
+ */
+class JobStatistics
+{
+public:
+    struct Histograms
+    {
+        void record(const Job &job);
+        void merge(const Histograms &other);
+
+        LogHistogram realTime;  ///< msec
+        LogHistogram userTime;  ///< msec
+        LogHistogram inBytes;   ///< uncompressed
+        LogHistogram outBytes;  ///< uncompressed
+    };
+
+    JobStatistics();
+
+    int maxPaths() const { return m_maxPaths; }
+    void setMaxPaths(int count);
+
+    /// Only successfully finished jobs are taken into account
+    void record(const Job &job);
+    void clear();
+
+    const Histograms &total() const { return m_total; }
+    /// @return nullptr if there are no statistics for the given key yet
+    const Histograms *server(HostId id) const;
+    const Histograms *client(HostId id) const;
+    const Histograms *path(PathTable::PathId id) const;
+
+    /// "p50 x / p90 x / p99 x / max x" for durations in msec
+    static QString durationSummary(const LogHistogram &histogram,
+                                   const QString &separator = QStringLiteral(" / "));
+    /// Same for sizes in bytes
+    static QString sizeSummary(const LogHistogram &histogram,
+                               const QString &separator = QStringLiteral(" / "));
+
+private:
+    struct PathHistograms
+    {
+        PathHistograms()
+            : lastUsed(0) {}
+
+        Histograms histograms;
+        quint64 lastUsed;
+    };
+
+    void evictPaths();
+
+    Histograms m_total;
+    QHash<HostId, Histograms> m_servers;
+    QHash<HostId, Histograms> m_clients;
+    QHash<PathTable::PathId, PathHistograms> m_paths;
+    int m_maxPaths;
+    quint64 m_tick;
+};
+
+#endif // ICEMON_JOBSTATISTICS_H
@@ -0,0 +1,105 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "loghistogram.h"
+
+#include <qmath.h>
+
+LogHistogram::LogHistogram()
+    : m_count(0)
+    , m_max(0)
+{
+}
+
+int LogHistogram::bucketIndex(quint64 value)
+{
+    if (value < LinearLimit) {
+        return int(value);
+    }
+
+    int msb = 63;
+    while (!(value & (Q_UINT64_C(1) << msb))) {
+        --msb;
+    }
+    const int shift = msb - SubBucketBits;
+    return (msb - SubBucketBits + 1) * SubBucketCount + int((value >> shift) & (SubBucketCount - 1));
+}
+
+quint64 LogHistogram::bucketValue(int index)
+{
+    if (index < LinearLimit) {
+        return quint64(index);
+    }
+
+    const int msb = index / SubBucketCount + SubBucketBits - 1;
+    const int shift = msb - SubBucketBits;
+    const quint64 lower = quint64(SubBucketCount + index % SubBucketCount) << shift;
+    return lower + ((Q_UINT64_C(1) << shift) >> 1);
+}
+
+void LogHistogram::record(quint64 value)
+{
+    const int index = bucketIndex(value);
+    if (index >= m_buckets.size()) {
+        m_buckets.resize(index + 1);
+    }
+    ++m_buckets[index];
+    ++m_count;
+    m_max = qMax(m_max, value);
+}
+
+void LogHistogram::merge(const LogHistogram &other)
+{
+    if (other.m_buckets.size() > m_buckets.size()) {
+        m_buckets.resize(other.m_buckets.size());
+    }
+    for (int i = 0; i < other.m_buckets.size(); ++i) {
+        m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+    m_max = qMax(m_max, other.m_max);
+}
+
+void LogHistogram::clear()
+{
+    m_buckets.clear();
+    m_count = 0;
+    m_max = 0;
+}
+
+quint64 LogHistogram::percentile(double percent) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+    if (percent >= 100) {
+        return m_max;
+    }
+
+    const quint64 rank = qMax<quint64>(1, quint64(qCeil(percent / 100 * m_count)));
+    quint64 seen = 0;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            return qMin(bucketValue(i), m_max);
+        }
+    }
+    return m_max;
+}
@@ -0,0 +1,66 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_LOGHISTOGRAM_H
+#define ICEMON_LOGHISTOGRAM_H
+
+#include <QVector>
+
+/**
+ * Mergeable histogram with logarithmic buckets
+ *
+ * Values below 16 are counted exactly, above that every power of two is
+ * split into 8 linear sub-buckets, so percentiles are accurate to about 6%.
+ * Recording is O(1), the bucket array only grows up to the largest value
+ * seen and never beyond 496 entries.
+ */
+class LogHistogram
+{
+public:
+    LogHistogram();
+
+    void record(quint64 value);
+    void merge(const LogHistogram &other);
+    void clear();
+
+    bool isEmpty() const { return m_count == 0; }
+    quint64 count() const { return m_count; }
+    quint64 max() const { return m_max; }
+
+    /// Value below which @p percent of the recorded values fall
+    quint64 percentile(double percent) const;
+
+private:
+    enum {
+        SubBucketBits = 3,
+        SubBucketCount = 1 << SubBucketBits,
+        LinearLimit = 2 * SubBucketCount
+    };
+
+    static int bucketIndex(quint64 value);
+    /// Midpoint of the value range covered by bucket @p index
+    static quint64 bucketValue(int index);
+
+    QVector<quint32> m_buckets;
+    quint64 m_count;
+    quint64 m_max;
+};
+
+#endif // ICEMON_LOGHISTOGRAM_H
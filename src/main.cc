@@ -24,16 +24,61 @@
 
 #include <QApplication>
 #include <QCommandLineParser>
+#include <QScopedPointer>
 
+#include "fakemonitor.h"
+#include "headlesscollector.h"
+#include "hostinfo.h"
+#include "icecreammonitor.h"
 #include "mainwindow.h"
+#include "metricsexporter.h"
+#include "replaymonitor.h"
 #include "version.h"
 
+namespace {
+
+// needs to be known before the application object exists
+bool isHeadless(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @return nullptr if the metrics endpoint could not be set up
+MetricsExporter *createMetricsExporter(Monitor *monitor, const QString &address, const QString &port)
+{
+    bool ok = false;
+    const quint16 portNumber = port.toUShort(&ok);
+    QHostAddress hostAddress;
+    if (!ok || !hostAddress.setAddress(address)) {
+        qWarning("Invalid metrics address %s:%s", qPrintable(address), qPrintable(port));
+        return nullptr;
+    }
+
+    MetricsExporter *exporter = new MetricsExporter(monitor, monitor);
+    if (!exporter->listen(hostAddress, portNumber)) {
+        qWarning("Cannot serve metrics on %s:%s: %s", qPrintable(address), qPrintable(port),
+                 qPrintable(exporter->errorString()));
+        delete exporter;
+        return nullptr;
+    }
+    return exporter;
+}
+
+}
+
 int main(int argc, char **argv)
 {
-    QApplication app(argc, argv);
-    QApplication::setOrganizationDomain(QStringLiteral("kde.org"));
-    QApplication::setApplicationName(QLatin1String(Icemon::Version::appShortName));
-    QApplication::setApplicationVersion(QLatin1String(Icemon::Version::version));
+    QScopedPointer<QCoreApplication> app(isHeadless(argc, argv)
+                                         ? new QCoreApplication(argc, argv)
+                                         : new QApplication(argc, argv));
+    QCoreApplication::setOrganizationDomain(QStringLiteral("kde.org"));
+    QCoreApplication::setApplicationName(QLatin1String(Icemon::Version::appShortName));
+    QCoreApplication::setApplicationVersion(QLatin1String(Icemon::Version::version));
 
     QCommandLineParser parser;
     parser.setApplicationDescription(QLatin1String(Icemon::Version::description));
@@ -50,12 +95,104 @@ int main(int argc, char **argv)
     QCommandLineOption testmodeOption(QStringLiteral("testmode"),
         QCoreApplication::translate("main", "Testing mode."));
     parser.addOption(testmodeOption);
+    QCommandLineOption recordOption(QStringLiteral("record"),
+        QCoreApplication::translate("main", "Record the scheduler traffic to an event log."),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(recordOption);
+    QCommandLineOption replayOption(QStringLiteral("replay"),
+        QCoreApplication::translate("main", "Replay a recorded event log instead of connecting to a scheduler."),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(replayOption);
+    QCommandLineOption replaySpeedOption(QStringLiteral("replay-speed"),
+        QCoreApplication::translate("main", "Replay speed factor, 0 replays as fast as possible."),
+        QCoreApplication::translate("main", "factor"), QStringLiteral("1"));
+    parser.addOption(replaySpeedOption);
+    QCommandLineOption headlessOption(QStringLiteral("headless"),
+        QCoreApplication::translate("main", "Run without user interface and periodically write job statistics."));
+    parser.addOption(headlessOption);
+    QCommandLineOption statsIntervalOption(QStringLiteral("stats-interval"),
+        QCoreApplication::translate("main", "Seconds between two statistics reports in headless mode."),
+        QCoreApplication::translate("main", "seconds"), QStringLiteral("60"));
+    parser.addOption(statsIntervalOption);
+    QCommandLineOption statsFileOption(QStringLiteral("stats-file"),
+        QCoreApplication::translate("main", "Append statistics reports to this file instead of stdout."),
+        QCoreApplication::translate("main", "file"));
+    parser.addOption(statsFileOption);
+    QCommandLineOption metricsPortOption(QStringLiteral("metrics-port"),
+        QCoreApplication::translate("main", "Serve Prometheus metrics via HTTP on this port."),
+        QCoreApplication::translate("main", "port"));
+    parser.addOption(metricsPortOption);
+    QCommandLineOption metricsAddressOption(QStringLiteral("metrics-address"),
+        QCoreApplication::translate("main", "Address to serve metrics on."),
+        QCoreApplication::translate("main", "address"), QStringLiteral("127.0.0.1"));
+    parser.addOption(metricsAddressOption);
 
-    parser.process(app);
+    parser.process(*app);
 
     const QByteArray netName = parser.value(netnameOption).toLatin1();
     const QByteArray schedName = parser.value(schednameOption).toLatin1();
 
+    double replaySpeed = 1.0;
+    if (parser.isSet(replayOption)) {
+        bool ok = false;
+        replaySpeed = parser.value(replaySpeedOption).toDouble(&ok);
+        if (!ok || replaySpeed < 0) {
+            parser.showHelp(1);
+        }
+    }
+
+    if (parser.isSet(headlessOption)) {
+        bool ok = false;
+        const int interval = parser.value(statsIntervalOption).toInt(&ok);
+        if (!ok || interval <= 0) {
+            parser.showHelp(1);
+        }
+
+        HostInfoManager hostInfoManager;
+        QScopedPointer<Monitor> monitor;
+        if (parser.isSet(replayOption)) {
+            ReplayMonitor *replayMonitor = new ReplayMonitor(&hostInfoManager, parser.value(replayOption));
+            monitor.reset(replayMonitor);
+            if (!replayMonitor->isValid()) {
+                return 1;
+            }
+            replayMonitor->setSpeed(replaySpeed);
+            QObject::connect(replayMonitor, SIGNAL(finished()), app.data(), SLOT(quit()));
+        } else if (parser.isSet(testmodeOption)) {
+            monitor.reset(new FakeMonitor(&hostInfoManager));
+        } else {
+            monitor.reset(new IcecreamMonitor(&hostInfoManager, nullptr));
+        }
+        if (!netName.isEmpty()) {
+            monitor->setCurrentNetname(netName);
+        }
+        if (!schedName.isEmpty()) {
+            monitor->setCurrentSchedname(schedName);
+        }
+        if (parser.isSet(recordOption)) {
+            EventMonitor *eventMonitor = qobject_cast<EventMonitor *>(monitor.data());
+            if (!eventMonitor || !eventMonitor->startRecording(parser.value(recordOption))) {
+                return 1;
+            }
+        }
+
+        if (parser.isSet(metricsPortOption)
+            && !createMetricsExporter(monitor.data(), parser.value(metricsAddressOption),
+                                      parser.value(metricsPortOption))) {
+            return 1;
+        }
+
+        HeadlessCollector collector(monitor.data());
+        collector.setInterval(interval);
+        if (!collector.setOutputFileName(parser.value(statsFileOption))) {
+            return 1;
+        }
+
+        const int ret = app->exec();
+        collector.writeReport();
+        return ret;
+    }
+
     MainWindow mainWindow;
     if (!netName.isEmpty()) {
         mainWindow.setCurrentNet(netName);
@@ -66,7 +203,22 @@ int main(int argc, char **argv)
     if (parser.isSet(testmodeOption)) {
         mainWindow.setTestModeEnabled(true);
     }
+    if (parser.isSet(replayOption)) {
+        if (!mainWindow.replay(parser.value(replayOption), replaySpeed)) {
+            return 1;
+        }
+    }
+    if (parser.isSet(recordOption)) {
+        if (!mainWindow.startRecording(parser.value(recordOption))) {
+            return 1;
+        }
+    }
+    if (parser.isSet(metricsPortOption)
+        && !createMetricsExporter(mainWindow.monitor(), parser.value(metricsAddressOption),
+                                  parser.value(metricsPortOption))) {
+        return 1;
+    }
     mainWindow.show();
 
-    return app.exec();
+    return app->exec();
 }
@@ -27,6 +27,7 @@
 #include "version.h"
 #include "fakemonitor.h"
 #include "icecreammonitor.h"
+#include "replaymonitor.h"
 #include "statusview.h"
 #include "statusviewfactory.h"
 
@@ -40,26 +41,19 @@
 #include <QApplication>
 #include <QSettings>
 #include <QMenu>
-
-#include <algorithm>
+#include <QTimer>
 
 namespace {
 
-struct PlatformStat
-{
-    PlatformStat()
-        : jobs(0)
-        , maxJobs(0) {}
-
-    unsigned int jobs;
-    unsigned int maxJobs;
-};
+// roughly one frame, job transitions arrive much faster than that
+const int JOB_STATS_INTERVAL_MSEC = 16;
 
 }
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_view(nullptr)
+    , m_jobStatsTimer(new QTimer(this))
 {
     QIcon appIcon = QIcon();
     appIcon.addFile(QStringLiteral(":/images/hi128-app-icemon.png"), QSize(128, 128));
@@ -81,6 +75,10 @@ MainWindow::MainWindow(QWidget *parent)
     m_jobStatsWidget->setVisible(false);
     statusBar()->addPermanentWidget(m_jobStatsWidget);
 
+    m_jobStatsTimer->setSingleShot(true);
+    m_jobStatsTimer->setInterval(JOB_STATS_INTERVAL_MSEC);
+    connect(m_jobStatsTimer, SIGNAL(timeout()), this, SLOT(updateJobStats()));
+
     QAction *action = fileMenu->addAction(tr("&Quit"), this, SLOT(close()), tr("Ctrl+Q"));
     action->setIcon(QIcon::fromTheme(QStringLiteral("application-exit")));
     action->setMenuRole(QAction::QuitRole);
@@ -181,26 +179,39 @@ void MainWindow::setMonitor(Monitor *monitor)
         return;
     }
 
+    Monitor *previous = m_monitor;
     if (m_monitor) {
         disconnect(m_monitor, SIGNAL(schedulerStateChanged(Monitor::SchedulerState)),
                    this, SLOT(updateSchedulerState(Monitor::SchedulerState)));
-        disconnect(m_monitor, SIGNAL(jobUpdated(const Job &)), this, SLOT(updateJob(Job)));
-        disconnect(m_monitor->hostInfoManager(), SIGNAL(hostMapChanged()), this, SLOT(updateJobStats()));
+        disconnect(m_monitor, SIGNAL(jobsUpdated(QVector<Job>)), this, SLOT(updateJobs(QVector<Job>)));
+        disconnect(m_monitor->hostInfoManager(), SIGNAL(hostChanged(HostId,HostInfo::Fields)),
+                   this, SLOT(updateHost(HostId,HostInfo::Fields)));
     }
 
     m_monitor = monitor;
+    m_platformStatistics.clear();
 
     if (m_monitor) {
+        foreach (const HostInfo *host, m_monitor->hostInfoManager()->hosts()) {
+            updatePlatformHost(*host);
+        }
+
         connect(m_monitor, SIGNAL(schedulerStateChanged(Monitor::SchedulerState)),
                 this, SLOT(updateSchedulerState(Monitor::SchedulerState)));
-        connect(m_monitor, SIGNAL(jobUpdated(const Job &)), this, SLOT(updateJob(Job)));
-        connect(m_monitor->hostInfoManager(), SIGNAL(hostMapChanged()), this, SLOT(updateJobStats()));
+        connect(m_monitor, SIGNAL(jobsUpdated(QVector<Job>)), this, SLOT(updateJobs(QVector<Job>)));
+        connect(m_monitor->hostInfoManager(), SIGNAL(hostChanged(HostId,HostInfo::Fields)),
+                this, SLOT(updateHost(HostId,HostInfo::Fields)));
+
+        m_monitor->jobHistory().readSettings();
     }
 
     if (m_view) {
         m_view->setMonitor(m_monitor);
     }
     updateSchedulerState(m_monitor ? m_monitor->schedulerState() : Monitor::Offline);
+
+    // stops the scheduler connection of a live monitor as well
+    delete previous;
 }
 
 StatusView *MainWindow::view() const
@@ -285,69 +296,69 @@ void MainWindow::updateSchedulerState(Monitor::SchedulerState state)
         m_schedStatusWidget->setText(tr("Scheduler is offline."));
     }
 
-    m_activeJobs.clear();
+    m_platformStatistics.clearJobs();
     updateJobStats();
 }
 
-void MainWindow::updateJob(const Job &job)
+void MainWindow::updateJobs(const QVector<Job> &jobs)
 {
-    if (job.isActive()) {
-        m_activeJobs[job.id] = job;
-        updateJobStats();
-    } else if (job.isDone()) {
-        m_activeJobs.remove(job.id);
-        updateJobStats();
+    bool changed = false;
+    foreach(const Job &job, jobs) {
+        changed |= m_platformStatistics.updateJob(job);
+    }
+
+    if (changed) {
+        scheduleJobStatsUpdate();
     }
 }
 
-void MainWindow::updateJobStats()
+void MainWindow::updateHost(HostId hostid, HostInfo::Fields fields)
 {
-    if (!m_monitor->schedulerState()) {
-        m_jobStatsWidget->clear();
-        m_jobStatsWidget->setVisible(false);
+    // load and speed change all the time but are not part of the job stats
+    const HostInfo::Fields shown = HostInfo::AddedField | HostInfo::PlatformField
+                                   | HostInfo::MaxJobsField | HostInfo::OfflineField
+                                   | HostInfo::NoRemoteField;
+    if (!(fields & shown)) {
         return;
     }
 
-    QMap<QString, PlatformStat> perPlatformStats;
-    const HostInfoManager::HostMap hostMap = m_monitor->hostInfoManager()->hostMap();
-    for (auto i = hostMap.begin(); i != hostMap.end(); ++i) {
-        if (!i.value()->isOffline() && !i.value()->noRemote()) {
-            perPlatformStats[i.value()->platform()].maxJobs += i.value()->maxJobs();
-        }
-    }
-    for (JobList::const_iterator i = m_activeJobs.constBegin(); i != m_activeJobs.constEnd(); ++i) {
-        const HostInfo *server = hostMap[i.value().server != 0 ? i.value().server : i.value().client];
-        if (!server->isOffline() && !server->noRemote()) {
-            ++perPlatformStats[server->platform()].jobs;
-        }
+    const HostInfo *host = m_hostInfoManager->find(hostid);
+    if (host && updatePlatformHost(*host)) {
+        scheduleJobStatsUpdate();
     }
+}
 
-    // Turn into something we can sort differently
-    QVector<QPair<QString, PlatformStat>> statistics;
-    for (auto it = perPlatformStats.constBegin(); it != perPlatformStats.constEnd(); ++it) {
-        statistics << qMakePair(it.key(), it.value());
+bool MainWindow::updatePlatformHost(const HostInfo &host)
+{
+    return m_platformStatistics.updateHost(host.id(), host.platform(), host.maxJobs(),
+                                           !host.isOffline() && !host.noRemote());
+}
+
+void MainWindow::scheduleJobStatsUpdate()
+{
+    if (!m_jobStatsTimer->isActive()) {
+        m_jobStatsTimer->start();
     }
+}
 
-    // Sort, move the platform with the highest max jobs count to the front
-    std::sort(statistics.begin(), statistics.end(), [](const QPair<QString, PlatformStat>& a,
-                                                       const QPair<QString, PlatformStat>& b) {
-        return a.second.maxJobs > b.second.maxJobs;
-    });
+void MainWindow::updateJobStats()
+{
+    m_jobStatsTimer->stop();
+
+    if (!m_monitor || !m_monitor->schedulerState()) {
+        m_jobStatsWidget->clear();
+        m_jobStatsWidget->setVisible(false);
+        return;
+    }
 
     // Compose the text
     QString text;
-    foreach (auto pair, statistics) {
-        const QString& platform = pair.first;
-        const PlatformStat& stat = pair.second;
-        if (stat.maxJobs == 0) {
-            continue;
-        }
-
+    foreach (const PlatformStatistics::Platform &stat, m_platformStatistics.platforms()) {
         if (!text.isEmpty()) {
             text.append(QStringLiteral(" - "));
         }
 
-        text.append(QStringLiteral("<strong>%2/%3</strong> on %1").arg(platform).arg(stat.jobs).arg(stat.maxJobs));
+        text.append(QStringLiteral("<strong>%2/%3</strong> on %1").arg(stat.name).arg(stat.jobs).arg(stat.maxJobs));
     }
 
     m_jobStatsWidget->setText(tr("| Active jobs: %1").arg(text));
@@ -381,3 +392,32 @@ void MainWindow::setTestModeEnabled(bool testMode)
         setMonitor(new IcecreamMonitor(m_hostInfoManager, this));
     }
 }
+
+bool MainWindow::replay(const QString &fileName, double speed)
+{
+    // start from no known hosts, so that the replay is reproducible
+    HostInfoManager *manager = new HostInfoManager;
+    ReplayMonitor *monitor = new ReplayMonitor(manager, fileName, this);
+    if (!monitor->isValid()) {
+        delete monitor;
+        delete manager;
+        return false;
+    }
+    monitor->setSpeed(speed);
+
+    HostInfoManager *previousManager = m_hostInfoManager;
+    m_hostInfoManager = manager;
+    setMonitor(monitor);
+    if (m_view) {
+        // views may still point to hosts of the previous manager
+        setView(StatusViewFactory::create(m_view->id(), this));
+    }
+    delete previousManager;
+    return true;
+}
+
+bool MainWindow::startRecording(const QString &fileName)
+{
+    EventMonitor *monitor = qobject_cast<EventMonitor *>(m_monitor);
+    return monitor && monitor->startRecording(fileName);
+}
@@ -27,14 +27,17 @@
 #include <QMainWindow>
 #include <QPointer>
 
+#include "hostinfo.h"
 #include "monitor.h"
 #include "job.h"
+#include "platformstatistics.h"
 
 class HostInfoManager;
 class StatusView;
 
 class QActionGroup;
 class QLabel;
+class QTimer;
 
 class MainWindow
     : public QMainWindow
@@ -52,6 +55,10 @@ public:
     StatusView *view() const;
 
     void setTestModeEnabled(bool testMode);
+    /// Replay the event log @p fileName instead of monitoring a scheduler
+    bool replay(const QString &fileName, double speed);
+    /// Record the scheduler traffic of the current monitor to @p fileName
+    bool startRecording(const QString &fileName);
 
 protected:
     void closeEvent(QCloseEvent *e) override;
@@ -63,16 +70,20 @@ private slots:
     void about();
 
     void updateSchedulerState(Monitor::SchedulerState state);
-    void updateJob(const Job &);
+    void updateJobs(const QVector<Job> &jobs);
     void updateJobStats();
+    void updateHost(HostId hostid, HostInfo::Fields fields);
 
     void handleViewModeActionTriggered(QAction *action);
 
 private:
     void readSettings();
     void writeSettings();
+    void scheduleJobStatsUpdate();
+    /// @return true if the job stats text needs to be updated
+    bool updatePlatformHost(const HostInfo &host);
 
-    /// Does *not* take ownership over @p monitor
+    /// Takes ownership over @p monitor, the previous monitor is deleted
     void setMonitor(Monitor *monitor);
     /// Takes ownership over @p view
     void setView(StatusView *view);
@@ -88,7 +99,9 @@ private:
     QAction *m_configureViewAction;
     QAction *m_pauseViewAction;
 
-    JobList m_activeJobs;
+    PlatformStatistics m_platformStatistics;
+    /// Coalesces job stats text updates to at most one per frame
+    QTimer *m_jobStatsTimer;
 };
 
 #endif // ICEMON_MAINWINDOW_H
@@ -0,0 +1,395 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "metricsexporter.h"
+
+#include "hostinfo.h"
+#include "monitor.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+
+#include <algorithm>
+
+namespace {
+
+const double REAL_TIME_BOUNDS[] = { 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60, 120, 300 };
+const double COMPRESSION_RATIO_BOUNDS[] = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1 };
+const double QUEUE_WAIT_BOUNDS[] = { 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10 };
+
+template<typename T, int N>
+int boundCount(const T (&)[N]) { return N; }
+
+/// Requests larger than this are not HTTP requests we care about
+const qint64 MAX_REQUEST_SIZE = 8192;
+
+/// Same as the jobs remembered by EventMonitor, whose done message may get lost
+const int MAX_REQUEST_TIMES = 10000;
+
+QString escapeLabel(QString value)
+{
+    value.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    value.replace(QLatin1Char('"'), QLatin1String("\\\""));
+    value.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+    return value;
+}
+
+void writeHeader(QTextStream &out, const char *name, const char *type, const char *help)
+{
+    out << "# HELP " << name << ' ' << help << '\n'
+        << "# TYPE " << name << ' ' << type << '\n';
+}
+
+}
+
+MetricsExporter::Histogram::Histogram(const double *bounds, int boundCount)
+    : bounds(bounds)
+    , buckets(boundCount + 1, 0)
+    , sum(0)
+    , count(0)
+{
+}
+
+void MetricsExporter::Histogram::observe(double value)
+{
+    int i = 0;
+    while (i < buckets.size() - 1 && value > bounds[i]) {
+        ++i;
+    }
+    ++buckets[i];
+    sum += value;
+    ++count;
+}
+
+void MetricsExporter::Histogram::write(QTextStream &out, const char *name) const
+{
+    quint64 cumulative = 0;
+    for (int i = 0; i < buckets.size(); ++i) {
+        cumulative += buckets[i];
+        out << name << "_bucket{le=\"";
+        if (i < buckets.size() - 1) {
+            // the bounds are short literals, keep them readable
+            out << QString::number(bounds[i]);
+        } else {
+            out << "+Inf";
+        }
+        out << "\"} " << cumulative << '\n';
+    }
+    out << name << "_sum " << sum << '\n'
+        << name << "_count " << count << '\n';
+}
+
+MetricsExporter::MetricsExporter(Monitor *monitor, QObject *parent)
+    : QObject(parent)
+    , m_monitor(monitor)
+    , m_server(new QTcpServer(this))
+    , m_requested(0)
+    , m_realTime(REAL_TIME_BOUNDS, boundCount(REAL_TIME_BOUNDS))
+    , m_compressionRatio(COMPRESSION_RATIO_BOUNDS, boundCount(COMPRESSION_RATIO_BOUNDS))
+    , m_queueWait(QUEUE_WAIT_BOUNDS, boundCount(QUEUE_WAIT_BOUNDS))
+{
+    m_clock.start();
+
+    // every single transition is needed here, batches collapse them
+    connect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(updateJob(Job)));
+    connect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(updateNode(HostId)));
+    connect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNode(HostId)));
+    connect(m_monitor.data(), SIGNAL(schedulerStateChanged(Monitor::SchedulerState)),
+            this, SLOT(updateSchedulerState(Monitor::SchedulerState)));
+    connect(m_server, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
+}
+
+MetricsExporter::~MetricsExporter()
+{
+}
+
+bool MetricsExporter::listen(const QHostAddress &address, quint16 port)
+{
+    return m_server->listen(address, port);
+}
+
+quint16 MetricsExporter::serverPort() const
+{
+    return m_server->serverPort();
+}
+
+QString MetricsExporter::errorString() const
+{
+    return m_server->errorString();
+}
+
+MetricsExporter::HostMetrics &MetricsExporter::host(HostId id)
+{
+    QHash<HostId, HostMetrics>::Iterator it = m_hosts.find(id);
+    if (it == m_hosts.end()) {
+        it = m_hosts.insert(id, HostMetrics());
+        (*it).name = QString::number(id);
+    }
+    return *it;
+}
+
+void MetricsExporter::updateNode(HostId id)
+{
+    const HostInfo *info = (m_monitor ? m_monitor->hostInfoManager()->find(id) : nullptr);
+    if (!info) {
+        return;
+    }
+
+    HostMetrics &metrics = host(id);
+    if (!info->name().isEmpty()) {
+        metrics.name = info->name();
+    }
+    metrics.platform = info->platform();
+    metrics.serverLoad = info->serverLoad();
+    metrics.maxJobs = info->maxJobs();
+    metrics.online = !info->isOffline();
+}
+
+void MetricsExporter::removeNode(HostId id)
+{
+    QHash<HostId, HostMetrics>::Iterator it = m_hosts.find(id);
+    if (it != m_hosts.end()) {
+        // keep the counters, they must be monotonic
+        (*it).online = false;
+        (*it).serverLoad = 0;
+    }
+}
+
+void MetricsExporter::updateSchedulerState(Monitor::SchedulerState state)
+{
+    if (state != Monitor::Offline) {
+        return;
+    }
+
+    // the monitor forgets its jobs without sending done events for them
+    m_activeJobs.clear();
+    m_activeJobsPerPlatform.clear();
+    m_requestTimes.clear();
+    for (QHash<HostId, HostMetrics>::Iterator it = m_hosts.begin(); it != m_hosts.end(); ++it) {
+        (*it).activeJobs = 0;
+    }
+}
+
+void MetricsExporter::pruneRequestTimes()
+{
+    QVector<qint64> times;
+    times.reserve(m_requestTimes.size());
+    for (QHash<unsigned int, qint64>::ConstIterator it = m_requestTimes.constBegin();
+         it != m_requestTimes.constEnd(); ++it) {
+        times.append(*it);
+    }
+    QVector<qint64>::iterator cutoff = times.begin() + times.size() / 4;
+    std::nth_element(times.begin(), cutoff, times.end());
+
+    for (QHash<unsigned int, qint64>::Iterator it = m_requestTimes.begin(); it != m_requestTimes.end();) {
+        if (*it <= *cutoff) {
+            it = m_requestTimes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MetricsExporter::jobStarted(const Job &job, HostId hostId)
+{
+    if (m_activeJobs.contains(job.id)) {
+        return;
+    }
+
+    HostMetrics &metrics = host(hostId);
+    ++metrics.started;
+    ++metrics.activeJobs;
+
+    ActiveJob active;
+    active.host = hostId;
+    active.platform = metrics.platform;
+    m_activeJobs.insert(job.id, active);
+    ++m_activeJobsPerPlatform[active.platform];
+}
+
+void MetricsExporter::jobStopped(unsigned int jobId)
+{
+    QHash<unsigned int, ActiveJob>::Iterator it = m_activeJobs.find(jobId);
+    if (it == m_activeJobs.end()) {
+        return;
+    }
+
+    --host((*it).host).activeJobs;
+    QHash<QString, int>::Iterator platform = m_activeJobsPerPlatform.find((*it).platform);
+    if (--(*platform) == 0) {
+        m_activeJobsPerPlatform.erase(platform);
+    }
+    m_activeJobs.erase(it);
+}
+
+void MetricsExporter::updateJob(const Job &job)
+{
+    switch (job.state) {
+    case Job::WaitingForCS:
+        if (!m_requestTimes.contains(job.id)) {
+            ++m_requested;
+            m_requestTimes.insert(job.id, m_clock.elapsed());
+            if (m_requestTimes.size() > MAX_REQUEST_TIMES) {
+                pruneRequestTimes();
+            }
+        }
+        break;
+    case Job::Compiling: {
+        QHash<unsigned int, qint64>::Iterator it = m_requestTimes.find(job.id);
+        if (it != m_requestTimes.end()) {
+            m_queueWait.observe((m_clock.elapsed() - *it) / 1000.0);
+            m_requestTimes.erase(it);
+        }
+        jobStarted(job, job.server);
+        break;
+    }
+    case Job::LocalOnly:
+        m_requestTimes.remove(job.id);
+        jobStarted(job, job.client);
+        break;
+    case Job::Finished:
+    case Job::Failed: {
+        m_requestTimes.remove(job.id);
+        jobStopped(job.id);
+
+        HostMetrics &metrics = host(job.server ? job.server : job.client);
+        if (job.state == Job::Failed) {
+            ++metrics.failed;
+            break;
+        }
+        ++metrics.finished;
+        if (job.real_msec) {
+            m_realTime.observe(job.real_msec / 1000.0);
+        }
+        if (job.in_uncompressed) {
+            m_compressionRatio.observe(double(job.in_compressed) / job.in_uncompressed);
+        }
+        break;
+    }
+    case Job::Idle:
+        break;
+    }
+}
+
+QByteArray MetricsExporter::metrics() const
+{
+    QByteArray data;
+    QTextStream out(&data, QIODevice::WriteOnly);
+    out.setRealNumberNotation(QTextStream::SmartNotation);
+    // enough digits for the sums to round-trip, rate() needs every change
+    out.setRealNumberPrecision(17);
+
+    writeHeader(out, "icemon_scheduler_online", "gauge", "Whether the monitor is connected to a scheduler");
+    out << "icemon_scheduler_online " << (m_monitor && m_monitor->schedulerState() == Monitor::Online ? 1 : 0) << '\n';
+
+    writeHeader(out, "icemon_jobs_requested_total", "counter", "Compile jobs requested from the scheduler");
+    out << "icemon_jobs_requested_total " << m_requested << '\n';
+
+    writeHeader(out, "icemon_jobs_active", "gauge", "Jobs currently compiling");
+    out << "icemon_jobs_active " << m_activeJobs.size() << '\n';
+
+    writeHeader(out, "icemon_platform_jobs_active", "gauge", "Jobs currently compiling per platform");
+    for (QHash<QString, int>::ConstIterator it = m_activeJobsPerPlatform.constBegin();
+         it != m_activeJobsPerPlatform.constEnd(); ++it) {
+        out << "icemon_platform_jobs_active{platform=\"" << escapeLabel(it.key()) << "\"} " << *it << '\n';
+    }
+
+    writeHostMetric(out, "icemon_host_jobs_started_total", "counter", "Jobs started on a host",
+                    [](const HostMetrics &host) { return host.started; });
+    writeHostMetric(out, "icemon_host_jobs_finished_total", "counter", "Jobs finished successfully on a host",
+                    [](const HostMetrics &host) { return host.finished; });
+    writeHostMetric(out, "icemon_host_jobs_failed_total", "counter", "Jobs failed on a host",
+                    [](const HostMetrics &host) { return host.failed; });
+    writeHostMetric(out, "icemon_host_jobs_active", "gauge", "Jobs currently compiling on a host",
+                    [](const HostMetrics &host) { return quint64(host.activeJobs); });
+    writeHostMetric(out, "icemon_host_load", "gauge", "Load of a host as reported by its daemon, in per mille",
+                    [](const HostMetrics &host) { return quint64(host.serverLoad); });
+    writeHostMetric(out, "icemon_host_max_jobs", "gauge", "Maximum number of parallel jobs of a host",
+                    [](const HostMetrics &host) { return quint64(host.maxJobs); });
+    writeHostMetric(out, "icemon_host_online", "gauge", "Whether a host is online",
+                    [](const HostMetrics &host) { return quint64(host.online ? 1 : 0); });
+
+    writeHeader(out, "icemon_job_duration_seconds", "histogram", "Wall clock time of finished jobs");
+    m_realTime.write(out, "icemon_job_duration_seconds");
+    writeHeader(out, "icemon_job_compression_ratio", "histogram", "Compressed to uncompressed size of job input");
+    m_compressionRatio.write(out, "icemon_job_compression_ratio");
+    writeHeader(out, "icemon_job_queue_wait_seconds", "histogram", "Time between requesting and starting a job");
+    m_queueWait.write(out, "icemon_job_queue_wait_seconds");
+
+    out.flush();
+    return data;
+}
+
+void MetricsExporter::writeHostMetric(QTextStream &out, const char *name, const char *type, const char *help,
+                                      quint64 (*value)(const HostMetrics &)) const
+{
+    writeHeader(out, name, type, help);
+    for (QHash<HostId, HostMetrics>::ConstIterator it = m_hosts.constBegin(); it != m_hosts.constEnd(); ++it) {
+        // names need not be unique, the id keeps the series apart
+        out << name << "{host=\"" << escapeLabel((*it).name) << "\",host_id=\"" << it.key() << "\"} "
+            << value(*it) << '\n';
+    }
+}
+
+void MetricsExporter::acceptConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    }
+}
+
+void MetricsExporter::readRequest()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket) {
+        return;
+    }
+
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > MAX_REQUEST_SIZE) {
+            socket->abort();
+        }
+        return;
+    }
+
+    // only the request line matters, e.g. "GET /metrics HTTP/1.1"
+    const QList<QByteArray> request = socket->readLine().simplified().split(' ');
+    disconnect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+
+    QByteArray status = "200 OK";
+    QByteArray body;
+    if (request.size() < 2 || request.at(0) != "GET") {
+        status = "405 Method Not Allowed";
+    } else if (request.at(1) != "/metrics") {
+        status = "404 Not Found";
+    } else {
+        body = metrics();
+    }
+
+    QByteArray response = "HTTP/1.0 " + status + "\r\n"
+                          "Content-Type: text/plain; version=0.0.4\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
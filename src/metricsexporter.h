@@ -0,0 +1,139 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_METRICSEXPORTER_H
+#define ICEMON_METRICSEXPORTER_H
+
+#include "job.h"
+#include "monitor.h"
+#include "types.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+class QTcpServer;
+class QTcpSocket;
+class QTextStream;
+
+/**
+ * Serves monitor metrics in the Prometheus text exposition format
+ *
+ * All values are maintained incrementally from the job and host update
+ * signals of the monitor; a scrape only formats what has been collected.
+ * Metrics are available via HTTP GET on /metrics.
+ */
+class MetricsExporter
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsExporter(Monitor *monitor, QObject *parent = nullptr);
+    ~MetricsExporter();
+
+    bool listen(const QHostAddress &address = QHostAddress::LocalHost, quint16 port = 0);
+    quint16 serverPort() const;
+    QString errorString() const;
+
+    /// The current metrics in text format
+    QByteArray metrics() const;
+
+private Q_SLOTS:
+    void updateJob(const Job &job);
+    void updateNode(HostId id);
+    void removeNode(HostId id);
+    void updateSchedulerState(Monitor::SchedulerState state);
+
+    void acceptConnection();
+    void readRequest();
+
+private:
+    /// Cumulative histogram with fixed upper bounds
+    struct Histogram
+    {
+        Histogram(const double *bounds, int boundCount);
+
+        void observe(double value);
+        void write(QTextStream &out, const char *name) const;
+
+        const double *bounds;
+        QVector<quint64> buckets; ///< one per bound plus +Inf
+        double sum;
+        quint64 count;
+    };
+
+    struct HostMetrics
+    {
+        HostMetrics()
+            : started(0)
+            , finished(0)
+            , failed(0)
+            , activeJobs(0)
+            , serverLoad(0)
+            , maxJobs(0)
+            , online(false) {}
+
+        QString name;
+        QString platform;
+        quint64 started;
+        quint64 finished;
+        quint64 failed;
+        int activeJobs;
+        unsigned int serverLoad;
+        unsigned int maxJobs;
+        bool online;
+    };
+
+    struct ActiveJob
+    {
+        HostId host;
+        QString platform;
+    };
+
+    HostMetrics &host(HostId id);
+    void writeHostMetric(QTextStream &out, const char *name, const char *type, const char *help,
+                         quint64 (*value)(const HostMetrics &)) const;
+    void jobStarted(const Job &job, HostId hostId);
+    void jobStopped(unsigned int jobId);
+    /// Drop the oldest quarter of m_requestTimes
+    void pruneRequestTimes();
+
+    QPointer<Monitor> m_monitor;
+    QTcpServer *m_server;
+
+    QHash<HostId, HostMetrics> m_hosts;
+    QHash<unsigned int, ActiveJob> m_activeJobs;
+    QHash<QString, int> m_activeJobsPerPlatform;
+    /// Monotonic time at which waiting jobs were requested, jobs which are
+    /// never started or finished are pruned beyond MAX_REQUEST_TIMES
+    QHash<unsigned int, qint64> m_requestTimes;
+    QElapsedTimer m_clock;
+
+    quint64 m_requested;
+    Histogram m_realTime;
+    Histogram m_compressionRatio;
+    Histogram m_queueWait;
+};
+
+#endif // ICEMON_METRICSEXPORTER_H
@@ -0,0 +1,236 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "flowtablemodel.h"
+
+#include "elidedtextcache.h"
+
+#include <QFont>
+#include <QIcon>
+
+FlowTableModel::FlowTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+QVariant FlowTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        switch (section) {
+        case ColumnHost:
+            return tr("Host");
+        case ColumnFile:
+            return tr("File");
+        case ColumnHistory:
+            return tr("History");
+        case ColumnState:
+            return tr("State");
+        default:
+            break;
+        }
+    }
+
+    return QVariant();
+}
+
+QVariant FlowTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size() || !m_hostInfoManager) {
+        return QVariant();
+    }
+
+    const Row &row = m_rows.at(index.row());
+    if (role == HostIdRole) {
+        return row.hostId;
+    } else if (role == HistoryLineRole) {
+        return row.historyLine;
+    }
+
+    const HostInfo *hostInfo = m_hostInfoManager->find(row.hostId);
+    if (!hostInfo) {
+        return QVariant();
+    }
+
+    switch (index.column()) {
+    case ColumnHost:
+        if (role == Qt::DisplayRole) {
+            return hostText(hostInfo, row.runningJobs);
+        } else if (role == SortRole) {
+            return hostInfo->name();
+        } else if (role == Qt::ToolTipRole) {
+            return hostInfo->toolTip();
+        } else if (role == Qt::DecorationRole) {
+            return QIcon(QStringLiteral(":/images/icemonnode.png"));
+        } else if (role == Qt::BackgroundRole) {
+            return hostInfo->color();
+        } else if (role == Qt::FontRole && row.runningJobs > 0) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        break;
+    case ColumnHistory:
+        if (role == SortRole) {
+            return hostInfo->maxJobs() ? double(row.runningJobs) / hostInfo->maxJobs() : 0.0;
+        }
+        break;
+    case ColumnFile:
+        if (!row.hasJob) {
+            break;
+        }
+        if (role == Qt::DisplayRole || role == SortRole) {
+            return ElidedTextCache::instance()->fileName(row.job.fileId);
+        } else if (role == Qt::ToolTipRole) {
+            return row.job.fileName();
+        }
+        break;
+    case ColumnState:
+        if (row.hasJob && (role == Qt::DisplayRole || role == Qt::ToolTipRole || role == SortRole)) {
+            return row.job.stateAsString();
+        }
+        break;
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+int FlowTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : _ColumnCount;
+}
+
+int FlowTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+HostInfoManager *FlowTableModel::hostInfoManager() const
+{
+    return m_hostInfoManager;
+}
+
+void FlowTableModel::setHostInfoManager(HostInfoManager *manager)
+{
+    beginResetModel();
+    m_hostInfoManager = manager;
+    m_rows.clear();
+    m_rowForHost.clear();
+    m_runningJobs.clear();
+    endResetModel();
+}
+
+void FlowTableModel::addHost(HostId hostId, int historyLine)
+{
+    if (contains(hostId)) {
+        return;
+    }
+
+    const Row row = { hostId, historyLine, 0, false, Job() };
+    beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size());
+    m_rowForHost.insert(hostId, m_rows.size());
+    m_rows.append(row);
+    endInsertRows();
+}
+
+int FlowTableModel::removeHost(HostId hostId)
+{
+    const int index = m_rowForHost.value(hostId, -1);
+    if (index < 0) {
+        return -1;
+    }
+
+    const int historyLine = m_rows.at(index).historyLine;
+    beginRemoveRows(QModelIndex(), index, index);
+    m_rows.remove(index);
+    m_rowForHost.remove(hostId);
+    // the rows below moved up
+    for (int i = index; i < m_rows.size(); ++i) {
+        m_rowForHost[m_rows.at(i).hostId] = i;
+    }
+    endRemoveRows();
+    return historyLine;
+}
+
+int FlowTableModel::historyLine(HostId hostId) const
+{
+    const int index = m_rowForHost.value(hostId, -1);
+    return index < 0 ? -1 : m_rows.at(index).historyLine;
+}
+
+void FlowTableModel::updateJob(const Job &job)
+{
+    const int index = m_rowForHost.value(job.server, -1);
+    if (index < 0) {
+        return;
+    }
+
+    Row &row = m_rows[index];
+    row.hasJob = (job.state != Job::Finished);
+    row.job = job;
+
+    // batches only carry the latest state of a job, so a job may arrive
+    // finished without ever having been seen running
+    if (job.isActive()) {
+        if (!m_runningJobs.contains(job.id)) {
+            m_runningJobs.insert(job.id, job.server);
+            ++row.runningJobs;
+        }
+    } else if (job.isDone()) {
+        const HostId hostId = m_runningJobs.take(job.id);
+        const int hostIndex = m_rowForHost.value(hostId, -1);
+        if (hostIndex >= 0) {
+            --m_rows[hostIndex].runningJobs;
+            if (hostIndex != index) {
+                emit dataChanged(this->index(hostIndex, 0), this->index(hostIndex, _ColumnCount - 1));
+            }
+        }
+    }
+
+    emit dataChanged(this->index(index, 0), this->index(index, _ColumnCount - 1));
+}
+
+void FlowTableModel::updateHost(HostId hostId)
+{
+    const int index = m_rowForHost.value(hostId, -1);
+    if (index >= 0) {
+        emit dataChanged(this->index(index, ColumnHost), this->index(index, ColumnHost));
+    }
+}
+
+QString FlowTableModel::hostText(HostId hostId) const
+{
+    const int index = m_rowForHost.value(hostId, -1);
+    const HostInfo *hostInfo = (m_hostInfoManager ? m_hostInfoManager->find(hostId) : nullptr);
+    if (index < 0 || !hostInfo) {
+        return QString();
+    }
+    return hostText(hostInfo, m_rows.at(index).runningJobs);
+}
+
+QString FlowTableModel::hostText(const HostInfo *hostInfo, int runningJobs) const
+{
+    if (hostInfo->serverSpeed() == 0) { // host disabled
+        return tr("%1 (Disabled)").arg(hostInfo->name());
+    } else {
+        return tr("%1 (%2/%3)").arg(hostInfo->name()).arg(runningJobs).arg(hostInfo->maxJobs());
+    }
+}
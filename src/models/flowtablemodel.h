@@ -0,0 +1,106 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_FLOWTABLEMODEL_H
+#define ICEMON_FLOWTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QPointer>
+#include <QVector>
+
+#include "hostinfo.h"
+#include "job.h"
+#include "types.h"
+
+/**
+ * One row per host, showing the job it is currently compiling
+ *
+ * Rows are looked up by host id. The History column has no data of its own,
+ * it only carries the line of the host in the FlowHistory for the delegate.
+ */
+class FlowTableModel
+    : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnHost,
+        ColumnFile,
+        ColumnHistory,
+        ColumnState,
+        _ColumnCount
+    };
+
+    enum Role
+    {
+        HostIdRole = Qt::UserRole,
+        HistoryLineRole,
+        SortRole    ///< the History column sorts by load
+    };
+
+    explicit FlowTableModel(QObject *parent = nullptr);
+
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    virtual QVariant data(const QModelIndex &index, int role) const override;
+    virtual int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    HostInfoManager *hostInfoManager() const;
+    /// Removes all hosts
+    void setHostInfoManager(HostInfoManager *manager);
+
+    bool contains(HostId hostId) const { return m_rowForHost.contains(hostId); }
+    void addHost(HostId hostId, int historyLine);
+    /// @return the history line of the removed host, -1 if it was unknown
+    int removeHost(HostId hostId);
+    /// -1 if @p hostId is not in the model
+    int historyLine(HostId hostId) const;
+
+    /// Update the row of the server of @p job
+    void updateJob(const Job &job);
+    /// The host info of @p hostId changed
+    void updateHost(HostId hostId);
+
+    /// Text of the host column, also used for sizing it
+    QString hostText(HostId hostId) const;
+
+private:
+    struct Row
+    {
+        HostId hostId;
+        int historyLine;
+        int runningJobs;
+        bool hasJob;    ///< false once the last job finished
+        Job job;
+    };
+
+    QString hostText(const HostInfo *hostInfo, int runningJobs) const;
+
+    QPointer<HostInfoManager> m_hostInfoManager;
+    QVector<Row> m_rows;
+    QHash<HostId, int> m_rowForHost;
+    /// server of each running job, counted in Row::runningJobs
+    QHash<unsigned int, HostId> m_runningJobs;
+};
+
+#endif // ICEMON_FLOWTABLEMODEL_H
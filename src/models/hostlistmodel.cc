@@ -45,7 +45,8 @@ void HostListModel::setMonitor(Monitor *monitor)
 
     if (m_monitor) {
         disconnect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNodeById(HostId)));
-        disconnect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+        disconnect(m_monitor->hostInfoManager(), SIGNAL(hostChanged(HostId,HostInfo::Fields)),
+                   this, SLOT(checkNode(HostId)));
     }
 
     beginResetModel();
@@ -56,7 +57,9 @@ void HostListModel::setMonitor(Monitor *monitor)
 
     if (m_monitor) {
         connect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNodeById(HostId)));
-        connect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+        // every column shows a host field, so only refresh rows that changed
+        connect(m_monitor->hostInfoManager(), SIGNAL(hostChanged(HostId,HostInfo::Fields)),
+                this, SLOT(checkNode(HostId)));
     }
 }
 
@@ -183,20 +186,17 @@ void HostListModel::checkNode(unsigned int hostid)
 {
     Q_ASSERT(m_monitor);
 
+    // hosts going offline are removed through Monitor::nodeRemoved()
     const HostInfo *info = m_monitor->hostInfoManager()->find(hostid);
-    if (!info) {
+    if (!info || info->isOffline()) {
         return;
     }
 
     const int index = m_hostInfos.indexOf(*info);
     if (index != -1) {
-        if (info->isOffline()) {
-            removeNodeById(hostid);
-        } else {
-            m_hostInfos[index] = *info;
-            emit dataChanged(indexForHostInfo(*info, 0), indexForHostInfo(*info, _ColumnCount - 1));
-        }
-    } else if (!info->isOffline()) {
+        m_hostInfos[index] = *info;
+        emit dataChanged(this->index(index, 0), this->index(index, _ColumnCount - 1));
+    } else {
         beginInsertRows(QModelIndex(), m_hostInfos.size(), m_hostInfos.size());
         m_hostInfos << *info;
         endInsertRows();
@@ -222,6 +222,10 @@ private:
 void HostListModel::removeNodeById(unsigned int hostId)
 {
     QVector<HostInfo>::iterator it = std::find_if(m_hostInfos.begin(), m_hostInfos.end(), find_hostid(hostId));
+    if (it == m_hostInfos.end()) {
+        return;
+    }
+
     int index = std::distance(m_hostInfos.begin(), it);
     beginRemoveRows(QModelIndex(), index, index);
     m_hostInfos.erase(it);
@@ -234,14 +238,9 @@ void HostListModel::fill()
         return;
     }
 
-    const HostInfoManager *manager = m_monitor->hostInfoManager();
-    const HostInfoManager::HostMap hosts(manager->hostMap());
-    foreach(int hostid, hosts.keys()) {
-        const HostInfo *info = m_monitor->hostInfoManager()->find(hostid);
-        if (!info) {
-            continue;
-        }
-
+    const HostSnapshot hosts = m_monitor->hostInfoManager()->hosts();
+    m_hostInfos.reserve(hosts.size());
+    foreach(const HostInfo *info, hosts) {
         m_hostInfos << *info;
     }
 }
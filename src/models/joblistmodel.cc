@@ -79,6 +79,7 @@ static QString trimFilePath(const QString &filePath, int numberOfFilePathParts)
 
 JobListModel::JobListModel(QObject *parent)
     : QAbstractListModel(parent)
+    , m_firstSlot(0)
     , m_numberOfFilePathParts(2)
     , m_expireDuration(-1)
     , m_expireTimer(new QTimer(this))
@@ -101,11 +102,11 @@ void JobListModel::setMonitor(Monitor *monitor)
     }
 
     if (m_monitor) {
-        disconnect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(updateJob(Job)));
+        disconnect(m_monitor.data(), SIGNAL(jobsUpdated(QVector<Job>)), this, SLOT(updateJobs(QVector<Job>)));
     }
     m_monitor = monitor;
     if (m_monitor) {
-        connect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(updateJob(Job)));
+        connect(m_monitor.data(), SIGNAL(jobsUpdated(QVector<Job>)), this, SLOT(updateJobs(QVector<Job>)));
     }
 }
 
@@ -117,33 +118,62 @@ void JobListModel::setHostId(unsigned int hostid)
     clear();
 }
 
+bool JobListModel::acceptsJob(const Job &job) const
+{
+    if (m_hostid && m_jobType == RemoteJobs && job.server != m_hostid)
+        return false;
+    if (m_hostid && m_jobType == LocalJobs && job.client != m_hostid)
+        return false;
+    return true;
+}
+
 void JobListModel::updateJob(const Job &job)
 {
-    const int index = m_jobs.indexOf(job);
-    if (index != -1) {
-        m_jobs[index] = job;
-        emit dataChanged(indexForJob(job, 0), indexForJob(job, _JobColumnCount - 1));
-    } else {
-        if (m_hostid && m_jobType == RemoteJobs && job.server != m_hostid)
-            return;
-        if (m_hostid && m_jobType == LocalJobs && job.client != m_hostid)
-            return;
-        beginInsertRows(QModelIndex(), m_jobs.size(), m_jobs.size());
-        m_jobs << job;
+    updateJobs(QVector<Job>() << job);
+}
+
+void JobListModel::updateJobs(const QVector<Job> &jobs)
+{
+    QVector<Job> newJobs;
+
+    foreach(const Job &job, jobs) {
+        QHash<unsigned int, int>::ConstIterator it = m_jobSlots.constFind(job.id);
+        if (it != m_jobSlots.constEnd()) {
+            const int row = *it - m_firstSlot;
+            m_jobs[*it] = job;
+            emit dataChanged(index(row, 0), index(row, _JobColumnCount - 1));
+        } else if (acceptsJob(job)) {
+            newJobs << job;
+        }
+    }
+
+    if (!newJobs.isEmpty()) {
+        const int firstSlot = m_jobs.size();
+        const int firstRow = firstSlot - m_firstSlot;
+        beginInsertRows(QModelIndex(), firstRow, firstRow + newJobs.size() - 1);
+        m_jobs << newJobs;
+        for (int slot = firstSlot; slot < m_jobs.size(); ++slot) {
+            m_jobSlots.insert(m_jobs.at(slot).id, slot);
+        }
         endInsertRows();
     }
 
-    const bool finished = (job.state == Job::Finished || job.state == Job::Failed);
-    if (finished) {
-        expireItem(job);
+    QVector<unsigned int> finishedJobIds;
+    foreach(const Job &job, jobs) {
+        if (job.isDone() && m_jobSlots.contains(job.id)) {
+            finishedJobIds << job.id;
+        }
     }
+    expireItems(finishedJobIds);
 }
 
 void JobListModel::clear()
 {
     beginResetModel();
     m_jobs.clear();
-    m_finishedJobs.clear();
+    m_jobSlots.clear();
+    m_firstSlot = 0;
+    m_finishedJobs.clear(QDateTime::currentDateTime().toTime_t());
     endResetModel();
 }
 
@@ -155,13 +185,19 @@ int JobListModel::columnCount(const QModelIndex &parent) const
 
 Job JobListModel::jobForIndex(const QModelIndex &index) const
 {
-    return m_jobs.value(index.row());
+    if (index.row() < 0 || index.row() >= rowCount()) {
+        return Job();
+    }
+    return m_jobs.at(m_firstSlot + index.row());
 }
 
-QModelIndex JobListModel::indexForJob(const Job &job, int column)
+QModelIndex JobListModel::indexForJob(const Job &job, int column) const
 {
-    const int i = m_jobs.indexOf(job);
-    return index(i, column);
+    QHash<unsigned int, int>::ConstIterator it = m_jobSlots.constFind(job.id);
+    if (it == m_jobSlots.constEnd()) {
+        return QModelIndex();
+    }
+    return index(*it - m_firstSlot, column);
 }
 
 QVariant JobListModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -208,7 +244,7 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
         case JobColumnID:
             return job.id;
         case JobColumnFilename:
-            return trimFilePath(job.fileName, m_numberOfFilePathParts);
+            return trimFilePath(job.fileName(), m_numberOfFilePathParts);
         case JobColumnClient:
             return manager->nameForHost(job.client);
         case JobColumnServer:
@@ -228,6 +264,17 @@ QVariant JobListModel::data(const QModelIndex &index, int role) const
         default:
             break;
         }
+    } else if (role == Qt::ToolTipRole) {
+        if (column == JobColumnFilename) {
+            const JobStatistics::Histograms *path = m_monitor->jobStatistics().path(job.fileId);
+            if (!path) {
+                return job.fileName();
+            }
+            return tr("%1\nDuration: %2\nInput: %3").arg(
+                job.fileName(),
+                JobStatistics::durationSummary(path->realTime),
+                JobStatistics::sizeSummary(path->inBytes));
+        }
     } else if (role == Qt::TextAlignmentRole) {
         switch (column) {
         case JobColumnID:
@@ -258,71 +305,118 @@ QModelIndex JobListModel::parent(const QModelIndex &child) const
 int JobListModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
-    return m_jobs.size();
+    return m_jobs.size() - m_firstSlot;
 }
 
-struct find_jobid
-    : public std::unary_function<Job, bool>
+void JobListModel::slotExpireFinishedJobs()
 {
-public:
-    find_jobid(unsigned int jobId)
-        : m_jobId(jobId) {}
+    const uint currentTime = QDateTime::currentDateTime().toTime_t();
 
-    bool operator()(const Job &job) const
-    {
-        return job.id == m_jobId;
-    }
+    removeItemsById(m_finishedJobs.advance(currentTime));
 
-private:
-    unsigned int m_jobId;
-};
+    if (m_finishedJobs.isEmpty()) {
+        m_expireTimer->stop();
+    }
+}
 
-void JobListModel::slotExpireFinishedJobs()
+void JobListModel::removeItemsById(const QVector<unsigned int> &jobIds)
 {
-    const uint currentTime = QDateTime::currentDateTime().toTime_t();
+    QVector<int> rows;
+    rows.reserve(jobIds.size());
+    foreach(unsigned int jobId, jobIds) {
+        QHash<unsigned int, int>::Iterator it = m_jobSlots.find(jobId);
+        if (it != m_jobSlots.end()) {
+            rows << *it - m_firstSlot;
+            m_jobSlots.erase(it);
+        }
+    }
 
-    // this list is sorted by the age of the finished jobs, the oldest is the first
-    // so we've to find the first job which isn't old enough to expire
-    FinishedJobs::iterator it = m_finishedJobs.begin();
-    for (const FinishedJobs::iterator itEnd = m_finishedJobs.end(); it != itEnd; ++it) {
-        if (currentTime - (*it).time < ( uint )m_expireDuration) {
-            break;
+    if (rows.isEmpty()) {
+        return;
+    }
+
+    // Remove contiguous ranges with one notification each, starting at the
+    // back so the remaining row numbers stay valid
+    std::sort(rows.begin(), rows.end());
+    int last = rows.size() - 1;
+    while (last >= 0) {
+        int first = last;
+        while (first > 0 && rows[first - 1] == rows[first] - 1) {
+            --first;
         }
 
-        unsigned int jobId = (*it).jobId;
-        removeItemById(jobId);
+        beginRemoveRows(QModelIndex(), rows[first], rows[last]);
+        removeRange(rows[first], rows[last]);
+        endRemoveRows();
+
+        last = first - 1;
     }
 
-    m_finishedJobs.erase(m_finishedJobs.begin(), it);
+    compact();
+    Q_ASSERT(m_jobSlots.size() == rowCount());
+}
 
-    if (m_finishedJobs.empty()) {
-        m_expireTimer->stop();
+void JobListModel::removeRange(int first, int last)
+{
+    const int count = last - first + 1;
+    const int firstSlot = m_firstSlot + first;
+
+    if (first < rowCount() - 1 - last) {
+        // fewer rows in front of the range, move them back over it
+        for (int slot = firstSlot - 1; slot >= m_firstSlot; --slot) {
+            m_jobs[slot + count] = m_jobs.at(slot);
+        }
+        std::fill(m_jobs.begin() + m_firstSlot, m_jobs.begin() + m_firstSlot + count, Job());
+        m_firstSlot += count;
+        reindexSlots(m_firstSlot, firstSlot + count);
+    } else {
+        m_jobs.remove(firstSlot, count);
+        reindexSlots(firstSlot, m_jobs.size());
     }
 }
 
-void JobListModel::removeItem(const Job &job)
+void JobListModel::compact()
 {
-    removeItemById(job.id);
+    // only drop the unused front once it outweighs the rows, so each
+    // removed row pays for moving at most one remaining row
+    if (m_firstSlot == 0 || m_firstSlot < m_jobs.size() - m_firstSlot) {
+        return;
+    }
+
+    m_jobs.remove(0, m_firstSlot);
+    m_firstSlot = 0;
+    reindexSlots(0, m_jobs.size());
 }
 
-void JobListModel::removeItemById(unsigned int jobId)
+void JobListModel::reindexSlots(int firstSlot, int endSlot)
 {
-    QVector<Job>::iterator it = std::find_if(m_jobs.begin(), m_jobs.end(), find_jobid(jobId));
-    int index = std::distance(m_jobs.begin(), it);
-    beginRemoveRows(QModelIndex(), index, index);
-    m_jobs.erase(it);
-    endRemoveRows();
+    for (int slot = firstSlot; slot < endSlot; ++slot) {
+        // rows of a batch which are still to be removed are no longer indexed
+        QHash<unsigned int, int>::Iterator it = m_jobSlots.find(m_jobs.at(slot).id);
+        if (it != m_jobSlots.end()) {
+            *it = slot;
+        }
+    }
 }
 
-void JobListModel::expireItem(const Job &job)
+void JobListModel::expireItems(const QVector<unsigned int> &jobIds)
 {
+    if (jobIds.isEmpty() || m_expireDuration < 0) {
+        return;
+    }
+
     if (m_expireDuration == 0) {
-        removeItem(job);
+        removeItemsById(jobIds);
         return;
     }
 
     const uint currentTime = QDateTime::currentDateTime().toTime_t();
-    m_finishedJobs.push_back(FinishedJob(currentTime, job.id));
+    if (m_finishedJobs.isEmpty()) {
+        m_finishedJobs.clear(currentTime);
+    }
+    foreach(unsigned int jobId, jobIds) {
+        m_finishedJobs.insert(currentTime + m_expireDuration, jobId);
+    }
 
     if (!m_expireTimer->isActive()) {
         m_expireTimer->start(1000);
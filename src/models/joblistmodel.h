@@ -22,8 +22,10 @@
 #define JOBLISTMODEL_H
 
 #include "job.h"
+#include "timingwheel.h"
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QSortFilterProxyModel>
 #include <QPointer>
 #include <QVector>
@@ -79,7 +81,7 @@ public:
     virtual int rowCount(const QModelIndex &parent = QModelIndex()) const override;
 
     Job jobForIndex(const QModelIndex &index) const;
-    QModelIndex indexForJob(const Job &job, int column);
+    QModelIndex indexForJob(const Job &job, int column) const;
 
     void setHostId(unsigned int hostid);
     unsigned int hostId() const { return m_hostid; }
@@ -90,14 +92,28 @@ private Q_SLOTS:
     void slotExpireFinishedJobs();
 
     void updateJob(const Job &job);
+    void updateJobs(const QVector<Job> &jobs);
     void clear();
 
 private:
+    /**
+     * Rows start at m_firstSlot, so removing rows at the front only moves
+     * the offset. Expired jobs are usually the oldest ones.
+     */
     QVector<Job> m_jobs;
-
-    void expireItem(const Job &job);
-    void removeItem(const Job &job);
-    void removeItemById(unsigned int jobId);
+    int m_firstSlot;
+    /// Maps job ids to their slot in m_jobs
+    QHash<unsigned int, int> m_jobSlots;
+
+    bool acceptsJob(const Job &job) const;
+    void expireItems(const QVector<unsigned int> &jobIds);
+    void removeItemsById(const QVector<unsigned int> &jobIds);
+    /// Remove rows @p first to @p last, moving whichever side of them is shorter
+    void removeRange(int first, int last);
+    /// Drop the unused slots in front of the rows once there are enough of them
+    void compact();
+    /// Update the slots of the indexed jobs in the given slot range
+    void reindexSlots(int firstSlot, int endSlot);
 
     QPointer<Monitor> m_monitor;
 
@@ -120,18 +136,8 @@ private:
      */
     int m_expireDuration;
 
-    struct FinishedJob
-    {
-        FinishedJob(uint _time = 0, uint _jobId = 0)
-            : time(_time)
-            , jobId(_jobId) {}
-        uint time;
-        uint jobId;
-    };
-    using FinishedJobs = QVector<JobListModel::FinishedJob>;
-
-    /// List with job ids that are expired
-    FinishedJobs m_finishedJobs;
+    /// Finished job ids keyed by the time (in seconds) they expire at
+    TimingWheel m_finishedJobs;
 
     QTimer *m_expireTimer;
     JobType m_jobType;
@@ -20,13 +20,17 @@
 
 #include "monitor.h"
 
-#include "statusview.h"
+#include <QTimer>
 
 Monitor::Monitor(HostInfoManager *manager, QObject *parent)
     : QObject(parent)
     , m_hostInfoManager(manager)
     , m_schedulerState(Offline)
+    , m_flushTimer(new QTimer(this))
 {
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(16);
+    connect(m_flushTimer, SIGNAL(timeout()), this, SLOT(flushJobUpdates()));
 }
 
 QByteArray Monitor::currentNetname() const
@@ -60,11 +64,62 @@ void Monitor::setSchedulerState(SchedulerState state)
         return;
     }
 
+    // deliver the jobs queued so far before the views react to the new state
+    flushJobUpdates();
+
     m_schedulerState = state;
     emit schedulerStateChanged(state);
 }
 
-QList<Job> Monitor::jobHistory() const
+JobList Monitor::activeJobs() const
+{
+    return JobList();
+}
+
+int Monitor::flushInterval() const
+{
+    return m_flushTimer->interval();
+}
+
+void Monitor::setFlushInterval(int msec)
+{
+    m_flushTimer->setInterval(msec);
+}
+
+void Monitor::notifyJobUpdated(const Job &job)
+{
+    emit jobUpdated(job);
+
+    if (job.isDone()) {
+        m_jobHistory.append(job);
+        m_jobStatistics.record(job);
+    }
+
+    // collapse multiple updates of the same job into its latest state
+    QHash<unsigned int, int>::ConstIterator it = m_pendingJobIndex.constFind(job.id);
+    if (it != m_pendingJobIndex.constEnd()) {
+        m_pendingJobs[*it] = job;
+    } else {
+        m_pendingJobIndex.insert(job.id, m_pendingJobs.size());
+        m_pendingJobs.append(job);
+    }
+
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void Monitor::flushJobUpdates()
 {
-    return QList<Job>();
+    m_flushTimer->stop();
+
+    if (m_pendingJobs.isEmpty()) {
+        return;
+    }
+
+    QVector<Job> jobs;
+    jobs.swap(m_pendingJobs);
+    m_pendingJobIndex.clear();
+
+    emit jobsUpdated(jobs);
 }
@@ -22,14 +22,20 @@
 #define ICEMON_MONITOR_H
 
 #include "job.h"
+#include "jobhistory.h"
+#include "jobstatistics.h"
 #include "types.h"
 
+#include <QHash>
 #include <QObject>
+#include <QVector>
 
 class StatusView;
 class HostInfoManager;
 class Job;
 
+class QTimer;
+
 /**
  * Abstract base class for monitoring a icecream-like scheduler
  */
@@ -49,24 +55,57 @@ public
     explicit Monitor(HostInfoManager *manager, QObject *parent = nullptr);
 
     QByteArray currentNetname() const;
-    void setCurrentNetname(const QByteArray &);
+    virtual void setCurrentNetname(const QByteArray &);
 
     QByteArray currentSchedname() const;
-    void setCurrentSchedname(const QByteArray &);
+    virtual void setCurrentSchedname(const QByteArray &);
 
     SchedulerState schedulerState() const;
 
-    virtual QList<Job> jobHistory() const;
+    /// Finished jobs, oldest first
+    const JobHistory &jobHistory() const { return m_jobHistory; }
+    JobHistory &jobHistory() { return m_jobHistory; }
+
+    /// Percentiles of the jobs finished so far
+    const JobStatistics &jobStatistics() const { return m_jobStatistics; }
+
+    /// Jobs which are currently waiting or compiling
+    virtual JobList activeJobs() const;
 
     HostInfoManager *hostInfoManager() const { return m_hostInfoManager; }
 
+    /**
+     * Interval in milliseconds in which queued job updates are delivered
+     * through jobsUpdated(). Default is 16 (about one frame).
+     */
+    int flushInterval() const;
+    void setFlushInterval(int msec);
+
+public Q_SLOTS:
+    /// Deliver all queued job updates right away
+    void flushJobUpdates();
+
 protected:
     void setSchedulerState(SchedulerState online);
 
+    /**
+     * Emits jobUpdated() and queues @p job for the next jobsUpdated() batch,
+     * finished jobs are recorded in the job history and statistics as well.
+     *
+     * Subclasses should call this instead of emitting jobUpdated() directly.
+     */
+    void notifyJobUpdated(const Job &job);
+
 Q_SIGNALS:
     void schedulerStateChanged(Monitor::SchedulerState);
 
+    /// Emitted for every single job state transition
     void jobUpdated(const Job &job);
+    /**
+     * Emitted at most once per flush interval with the latest state of each
+     * job updated since the last batch, in order of first update
+     */
+    void jobsUpdated(const QVector<Job> &jobs);
     void nodeRemoved(HostId id);
     void nodeUpdated(HostId id);
 
@@ -75,6 +114,13 @@ private:
     QByteArray m_currentNetname;
     QByteArray m_currentSchedname;
     SchedulerState m_schedulerState;
+
+    JobHistory m_jobHistory;
+    JobStatistics m_jobStatistics;
+
+    QVector<Job> m_pendingJobs;
+    QHash<unsigned int, int> m_pendingJobIndex;
+    QTimer *m_flushTimer;
 };
 
 #endif // ICEMON_MONITOR_H
@@ -0,0 +1,92 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_MONITOREVENT_H
+#define ICEMON_MONITOREVENT_H
+
+#include "hoststats.h"
+#include "job.h"
+
+#include <QString>
+
+#include <time.h>
+
+/**
+ * A decoded scheduler monitor message
+ *
+ * Produced by the scheduler connection thread and consumed by the monitor
+ * on the GUI thread, so it must not reference any icecc types.
+ */
+struct MonitorEvent
+{
+    enum Type {
+        SchedulerOnline,    ///< schedulerName and networkName are set
+        SchedulerOffline,
+        JobRequested,       ///< M_MON_GET_CS, hostId is the client
+        JobBegin,           ///< M_MON_JOB_BEGIN, hostId is the server
+        JobDone,            ///< M_MON_JOB_DONE
+        LocalJobBegin,      ///< M_MON_LOCAL_JOB_BEGIN, hostId is the client
+        LocalJobDone,       ///< M_JOB_LOCAL_DONE
+        HostStats           ///< M_MON_STATS, hostId is the reporting daemon
+    };
+
+    explicit MonitorEvent(Type type = SchedulerOffline)
+        : type(type)
+        , jobId(0)
+        , hostId(0)
+        , lang(Job::Lang_Unknown)
+        , startTime(0)
+        , exitcode(0)
+        , real_msec(0)
+        , user_msec(0)
+        , sys_msec(0)
+        , pfaults(0)
+        , in_compressed(0)
+        , in_uncompressed(0)
+        , out_compressed(0)
+        , out_uncompressed(0)
+    {
+    }
+
+    Type type;
+    unsigned int jobId;
+    unsigned int hostId;
+
+    QString fileName;
+    Job::Language lang;
+    time_t startTime;
+
+    int exitcode;
+    unsigned int real_msec;
+    unsigned int user_msec;
+    unsigned int sys_msec;
+    unsigned int pfaults;
+    unsigned int in_compressed;
+    unsigned int in_uncompressed;
+    unsigned int out_compressed;
+    unsigned int out_uncompressed;
+
+    HostStats stats;
+
+    QString schedulerName;
+    QString networkName;
+};
+
+#endif // ICEMON_MONITOREVENT_H
@@ -0,0 +1,137 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pathtable.h"
+
+#include <QHash>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+
+namespace {
+
+struct Entry
+{
+    QString path;
+    quint64 lastUsed;
+};
+
+struct Table
+{
+    Table()
+        : nextId(1)
+        , tick(0)
+        , maxCount(PathTable::DefaultMaxCount)
+        , thread(QThread::currentThread())
+    {
+    }
+
+    QHash<PathTable::PathId, Entry> paths;
+    QHash<QString, PathTable::PathId> ids;
+    PathTable::PathId nextId;
+    quint64 tick;
+    int maxCount;
+    QThread *thread;
+};
+
+Table &table()
+{
+    static Table instance;
+    Q_ASSERT_X(instance.thread == QThread::currentThread(), "PathTable", "used from more than one thread");
+    return instance;
+}
+
+void evict(Table &t)
+{
+    // drop the least recently interned quarter, so this happens rarely
+    QVector<quint64> ages;
+    ages.reserve(t.paths.size());
+    for (QHash<PathTable::PathId, Entry>::ConstIterator it = t.paths.constBegin(); it != t.paths.constEnd(); ++it) {
+        ages.append((*it).lastUsed);
+    }
+    const int keep = t.maxCount - t.maxCount / 4;
+    QVector<quint64>::iterator cutoff = ages.begin() + (ages.size() - keep);
+    std::nth_element(ages.begin(), cutoff, ages.end());
+
+    for (QHash<PathTable::PathId, Entry>::Iterator it = t.paths.begin(); it != t.paths.end();) {
+        if ((*it).lastUsed < *cutoff) {
+            t.ids.remove((*it).path);
+            it = t.paths.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}
+
+PathTable::PathId PathTable::intern(const QString &path)
+{
+    if (path.isEmpty()) {
+        return 0;
+    }
+
+    Table &t = table();
+    QHash<QString, PathId>::ConstIterator it = t.ids.constFind(path);
+    if (it != t.ids.constEnd()) {
+        t.paths[*it].lastUsed = ++t.tick;
+        return *it;
+    }
+
+    const PathId id = t.nextId++;
+    const Entry entry = { path, ++t.tick };
+    t.paths.insert(id, entry);
+    t.ids.insert(path, id);
+    if (t.paths.size() > t.maxCount) {
+        evict(t);
+    }
+    return id;
+}
+
+QString PathTable::path(PathId id)
+{
+    if (id == 0) {
+        return QString();
+    }
+
+    const Table &t = table();
+    QHash<PathId, Entry>::ConstIterator it = t.paths.constFind(id);
+    return (it != t.paths.constEnd() ? (*it).path : QString());
+}
+
+int PathTable::count()
+{
+    return table().paths.size();
+}
+
+int PathTable::maxCount()
+{
+    return table().maxCount;
+}
+
+void PathTable::setMaxCount(int count)
+{
+    Table &t = table();
+    t.maxCount = qMax(1, count);
+    if (t.paths.size() > t.maxCount) {
+        evict(t);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_PATHTABLE_H
+#define ICEMON_PATHTABLE_H
+
+#include <QString>
+
+/**
+ * Process-wide interning table for source file paths
+ *
+ * Jobs only carry a 32-bit id, the string for each distinct path is stored
+ * once. Id 0 always maps to the empty path. Ids are never reused.
+ *
+ * The table holds at most maxCount() paths. Beyond that the least recently
+ * interned quarter is dropped, and jobs referring to those paths get an
+ * empty file name. The default is well above the number of jobs kept in
+ * the JobHistory.
+ *
+ * Not thread-safe: only use it from the thread which first used it, which
+ * is the one the monitor lives in.
+ */
+namespace PathTable {
+using PathId = quint32;
+
+enum {
+    DefaultMaxCount = 250000
+};
+
+PathId intern(const QString &path);
+/// Empty if @p id was evicted
+QString path(PathId id);
+
+/// Number of distinct paths held
+int count();
+
+int maxCount();
+void setMaxCount(int count);
+}
+
+#endif // ICEMON_PATHTABLE_H
@@ -0,0 +1,144 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "platformstatistics.h"
+
+#include <algorithm>
+
+PlatformStatistics::PlatformStatistics()
+{
+}
+
+void PlatformStatistics::clear()
+{
+    m_platforms.clear();
+    m_platformIndex.clear();
+    m_hosts.clear();
+    m_jobHosts.clear();
+}
+
+void PlatformStatistics::clearJobs()
+{
+    for (QVector<Platform>::iterator it = m_platforms.begin(); it != m_platforms.end(); ++it) {
+        (*it).jobs = 0;
+    }
+    for (QHash<HostId, Host>::iterator it = m_hosts.begin(); it != m_hosts.end(); ++it) {
+        (*it).jobs = 0;
+    }
+    m_jobHosts.clear();
+}
+
+int PlatformStatistics::platformIndex(const QString &name)
+{
+    QHash<QString, int>::const_iterator it = m_platformIndex.constFind(name);
+    if (it != m_platformIndex.constEnd()) {
+        return *it;
+    }
+
+    Platform platform;
+    platform.name = name;
+    m_platforms.append(platform);
+    m_platformIndex.insert(name, m_platforms.size() - 1);
+    return m_platforms.size() - 1;
+}
+
+bool PlatformStatistics::updateHost(HostId id, const QString &platform, unsigned int maxJobs,
+                                    bool available)
+{
+    Host &host = m_hosts[id];
+    const int index = platformIndex(platform);
+    if (host.platform == index && host.maxJobs == maxJobs && host.available == available) {
+        return false;
+    }
+
+    const bool wasCounted = host.isCounted();
+    if (wasCounted) {
+        Platform &old = m_platforms[host.platform];
+        old.maxJobs -= host.maxJobs;
+        old.jobs -= host.jobs;
+    }
+
+    host.platform = index;
+    host.maxJobs = maxJobs;
+    host.available = available;
+
+    if (host.isCounted()) {
+        Platform &current = m_platforms[host.platform];
+        current.maxJobs += host.maxJobs;
+        current.jobs += host.jobs;
+        return true;
+    }
+    return wasCounted;
+}
+
+bool PlatformStatistics::addJob(HostId hostId, int delta)
+{
+    // jobs may refer to hosts we have not seen stats for yet
+    Host &host = m_hosts[hostId];
+    host.jobs += delta;
+    if (!host.isCounted()) {
+        return false;
+    }
+    m_platforms[host.platform].jobs += delta;
+    return true;
+}
+
+bool PlatformStatistics::updateJob(const Job &job)
+{
+    const HostId hostId = (job.server != 0 ? job.server : job.client);
+
+    QHash<unsigned int, HostId>::iterator it = m_jobHosts.find(job.id);
+    if (job.isActive()) {
+        bool changed = false;
+        if (it == m_jobHosts.end()) {
+            m_jobHosts.insert(job.id, hostId);
+        } else if (*it != hostId) {
+            changed = addJob(*it, -1);
+            *it = hostId;
+        } else {
+            return false;
+        }
+        return addJob(hostId, 1) || changed;
+    }
+
+    if (job.isDone() && it != m_jobHosts.end()) {
+        const bool changed = addJob(*it, -1);
+        m_jobHosts.erase(it);
+        return changed;
+    }
+    return false;
+}
+
+QVector<PlatformStatistics::Platform> PlatformStatistics::platforms() const
+{
+    QVector<Platform> platforms;
+    platforms.reserve(m_platforms.size());
+    foreach (const Platform &platform, m_platforms) {
+        if (platform.maxJobs > 0) {
+            platforms.append(platform);
+        }
+    }
+
+    // move the platform with the highest max jobs count to the front
+    std::sort(platforms.begin(), platforms.end(), [](const Platform &a, const Platform &b) {
+        return a.maxJobs > b.maxJobs;
+    });
+    return platforms;
+}
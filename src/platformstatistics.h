@@ -0,0 +1,96 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_PLATFORMSTATISTICS_H
+#define ICEMON_PLATFORMSTATISTICS_H
+
+#include "job.h"
+#include "types.h"
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * Running and available job slots per platform
+ *
+ * Hosts that are offline or do not accept remote jobs are not counted. Active
+ * jobs are counted on their server, or on their client while no server has
+ * been assigned yet. All updates are O(1); only platforms() walks the table.
+ */
+class PlatformStatistics
+{
+public:
+    struct Platform
+    {
+        Platform()
+            : jobs(0)
+            , maxJobs(0) {}
+
+        QString name;
+        unsigned int jobs;
+        unsigned int maxJobs;
+    };
+
+    PlatformStatistics();
+
+    void clear();
+    /// Forget all jobs, e.g. after the scheduler went away
+    void clearJobs();
+
+    /**
+     * @param available false if the host is offline or refuses remote jobs
+     * @return true if the totals of any platform changed
+     */
+    bool updateHost(HostId id, const QString &platform, unsigned int maxJobs, bool available);
+    /// @return true if the totals of any platform changed
+    bool updateJob(const Job &job);
+
+    /// Platforms with at least one slot, the largest first
+    QVector<Platform> platforms() const;
+
+private:
+    struct Host
+    {
+        Host()
+            : platform(-1)
+            , maxJobs(0)
+            , jobs(0)
+            , available(false) {}
+
+        bool isCounted() const { return available && platform >= 0; }
+
+        int platform;           ///< index into m_platforms
+        unsigned int maxJobs;
+        unsigned int jobs;      ///< active jobs counted on this host
+        bool available;
+    };
+
+    int platformIndex(const QString &name);
+    /// @return true if the host is counted in its platform totals
+    bool addJob(HostId hostId, int delta);
+
+    QVector<Platform> m_platforms;
+    QHash<QString, int> m_platformIndex;
+    QHash<HostId, Host> m_hosts;
+    QHash<unsigned int, HostId> m_jobHosts;
+};
+
+#endif // ICEMON_PLATFORMSTATISTICS_H
@@ -0,0 +1,121 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "replaymonitor.h"
+
+#include "monitorevent.h"
+
+#include <QDebug>
+#include <QTimer>
+
+namespace {
+
+/// Upper bound for applying events in one go, keeps the GUI responsive
+const qint64 MAX_EVENT_SLICE_MSEC = 8;
+
+}
+
+ReplayMonitor::ReplayMonitor(HostInfoManager *manager, const QString &fileName, QObject *parent)
+    : EventMonitor(manager, parent)
+    , m_valid(false)
+    , m_speed(1.0)
+    , m_timer(new QTimer(this))
+    , m_logTimeOffset(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(replay()));
+
+    m_valid = m_log.open(fileName);
+    if (!m_valid) {
+        qWarning() << "Cannot replay" << fileName << m_log.errorString();
+        return;
+    }
+
+    m_clock.start();
+    m_timer->start(0);
+}
+
+void ReplayMonitor::setSpeed(double speed)
+{
+    // keep the current log position when changing speed
+    m_logTimeOffset = logTime();
+    m_clock.restart();
+    m_speed = qMax(0.0, speed);
+    if (m_timer->isActive()) {
+        scheduleNext();
+    }
+}
+
+qint64 ReplayMonitor::logTime() const
+{
+    return m_logTimeOffset + qint64(m_clock.elapsed() * m_speed);
+}
+
+void ReplayMonitor::replay()
+{
+    QElapsedTimer slice;
+    slice.start();
+
+    const qint64 now = logTime();
+    MonitorEvent event;
+    qint64 timestamp = now;
+    while (!m_log.atEnd()) {
+        if (m_speed > 0 && m_log.nextTimestamp() > now) {
+            break;
+        }
+        if (!m_log.next(&event, &timestamp)) {
+            break;
+        }
+        handleEvent(event);
+
+        if (slice.elapsed() >= MAX_EVENT_SLICE_MSEC) {
+            break;
+        }
+    }
+
+    if (m_speed == 0) {
+        // as fast as possible: keep log time in sync with what was replayed
+        m_logTimeOffset = timestamp;
+        m_clock.restart();
+    }
+
+    scheduleNext();
+}
+
+void ReplayMonitor::scheduleNext()
+{
+    if (!m_valid) {
+        return;
+    }
+
+    if (m_log.atEnd()) {
+        m_timer->stop();
+        flushJobUpdates();
+        emit finished();
+        return;
+    }
+
+    qint64 delay = 0;
+    if (m_speed > 0) {
+        delay = qMax<qint64>(0, qint64((m_log.nextTimestamp() - logTime()) / m_speed));
+    }
+    m_timer->start(int(qMin<qint64>(delay, 60 * 1000)));
+}
@@ -0,0 +1,74 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_REPLAYMONITOR_H
+#define ICEMON_REPLAYMONITOR_H
+
+#include "eventmonitor.h"
+#include "eventlog.h"
+
+#include <QElapsedTimer>
+
+class QTimer;
+
+/**
+ * Monitor replaying an event log written by EventMonitor::startRecording()
+ *
+ * The log is memory-mapped and decoded on the fly. A speed of 1 replays in
+ * real time, N replays N times faster and 0 replays as fast as possible
+ * while still returning to the event loop regularly.
+ */
+class ReplayMonitor
+    : public EventMonitor
+{
+    Q_OBJECT
+
+public:
+    ReplayMonitor(HostInfoManager *manager, const QString &fileName, QObject *parent = nullptr);
+
+    bool isValid() const { return m_valid; }
+    QString errorString() const { return m_log.errorString(); }
+
+    double speed() const { return m_speed; }
+    void setSpeed(double speed);
+
+Q_SIGNALS:
+    /// Emitted once the whole log has been replayed
+    void finished();
+
+private Q_SLOTS:
+    void replay();
+
+private:
+    void scheduleNext();
+    /// Position in the log, in milliseconds, reached at this moment
+    qint64 logTime() const;
+
+    EventLogReader m_log;
+    bool m_valid;
+    double m_speed;
+
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    /// Log time at which m_clock was (re)started
+    qint64 m_logTimeOffset;
+};
+
+#endif // ICEMON_REPLAYMONITOR_H
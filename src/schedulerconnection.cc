@@ -0,0 +1,309 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2003 Frerich Raabe <raabe@kde.org>
+    Copyright (c) 2003,2004 Stephan Kulow <coolo@kde.org>
+    Copyright (c) 2003,2004 Cornelius Schumacher <schumacher@kde.org>
+    Copyright (c) 2007 Dirk Mueller <mueller@kde.org>
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "schedulerconnection.h"
+
+#include <icecc/comm.h>
+
+#include <QThread>
+#include <QTimer>
+
+#include <list>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+// TODO: Just use QByteArray static methods when depending on Qt 5.4
+inline QByteArray QBA_fromStdString(const std::string& s)
+{ return QByteArray(s.data(), int(s.size())); }
+inline std::string QBA_toStdString(const QByteArray& s)
+{ return std::string(s.constData(), s.length()); }
+
+}
+
+SchedulerConnection::SchedulerConnection(QObject *parent)
+    : QObject(parent)
+    , m_events(16384)
+    , m_scheduler(nullptr)
+    , m_discover(nullptr)
+    , m_fd_notify(nullptr)
+    , m_fd_type(QSocketNotifier::Exception)
+    , m_online(false)
+{
+}
+
+SchedulerConnection::~SchedulerConnection()
+{
+    delete m_scheduler;
+    delete m_discover;
+}
+
+void SchedulerConnection::start()
+{
+    checkScheduler();
+}
+
+void SchedulerConnection::setNetname(const QByteArray &netname)
+{
+    m_netname = netname;
+}
+
+void SchedulerConnection::setSchedname(const QByteArray &schedname)
+{
+    m_schedname = schedname;
+}
+
+bool SchedulerConnection::takeEvent(MonitorEvent *event)
+{
+    return m_events.tryPop(event);
+}
+
+void SchedulerConnection::acknowledgeEvents()
+{
+    m_notificationPending.storeRelease(0);
+}
+
+void SchedulerConnection::postEvent(MonitorEvent &&event)
+{
+    // The consumer drains in bounded slices, so a full queue only happens
+    // if the GUI thread is stalled; apply back-pressure to the socket then.
+    while (!m_events.tryPush(std::move(event))) {
+        if (QThread::currentThread()->isInterruptionRequested()) {
+            return;
+        }
+        QThread::yieldCurrentThread();
+    }
+
+    if (m_notificationPending.testAndSetOrdered(0, 1)) {
+        emit eventsAvailable();
+    }
+}
+
+void SchedulerConnection::setOnline(bool online)
+{
+    if (m_online == online) {
+        return;
+    }
+
+    m_online = online;
+
+    MonitorEvent event(online ? MonitorEvent::SchedulerOnline : MonitorEvent::SchedulerOffline);
+    if (online) {
+        event.schedulerName = QString::fromLatin1(m_discover->schedulerName().data());
+        event.networkName = QString::fromLatin1(m_discover->networkName().data());
+    }
+    postEvent(std::move(event));
+}
+
+void SchedulerConnection::checkScheduler(bool deleteit)
+{
+    if (deleteit) {
+        delete m_scheduler;
+        m_scheduler = nullptr;
+        delete m_fd_notify;
+        m_fd_notify = nullptr;
+        m_fd_type = QSocketNotifier::Exception;
+        delete m_discover;
+        m_discover = nullptr;
+        setOnline(false);
+    } else if (m_scheduler) {
+        return;
+    }
+    QTimer::singleShot(1000 + (qrand() & 1023), this, SLOT(slotCheckScheduler())); // TODO: check if correct
+}
+
+void SchedulerConnection::registerNotify(int fd, QSocketNotifier::Type type, const char *slot)
+{
+    if (m_fd_notify) {
+        m_fd_notify->disconnect(this);
+        m_fd_notify->deleteLater();
+    }
+    m_fd_notify = new QSocketNotifier(fd, type, this);
+    m_fd_type = type;
+    QObject::connect(m_fd_notify, SIGNAL(activated(int)), slot);
+}
+
+void SchedulerConnection::slotCheckScheduler()
+{
+    if (m_scheduler) {
+        return;
+    }
+
+    const string hostname = m_schedname.isEmpty() ? "" : m_schedname.data();
+    list<string> names;
+
+    if (!m_netname.isEmpty()) {
+        names.push_front(m_netname.data());
+    } else {
+        names.push_front("ICECREAM");
+    }
+
+    if (!qgetenv("USE_SCHEDULER").isEmpty()) {
+        names.push_front(""); // try $USE_SCHEDULER
+    }
+    for (list<string>::const_iterator it = names.begin(); it != names.end();
+         ++it) {
+        m_netname = QBA_fromStdString(*it);
+        if (!m_discover
+            || m_discover->timed_out()) {
+            delete m_discover;
+            m_discover = new DiscoverSched(QBA_toStdString(m_netname), 2, hostname);
+        }
+
+        m_scheduler = m_discover->try_get_scheduler();
+
+        if (m_scheduler) {
+            m_scheduler->setBulkTransfer();
+            registerNotify(m_scheduler->fd,
+                           QSocketNotifier::Read, SLOT(msgReceived()));
+
+            if (!m_scheduler->send_msg(MonLoginMsg())) {
+                checkScheduler(true);
+                QTimer::singleShot(0, this, SLOT(slotCheckScheduler()));
+            } else {
+                setOnline(true);
+            }
+            delete m_discover;
+            m_discover = nullptr;
+            return;
+        }
+
+        if (m_fd_type != QSocketNotifier::Write
+            && m_discover->connect_fd() >= 0) {
+            registerNotify(m_discover->connect_fd(),
+                           QSocketNotifier::Write, SLOT(slotCheckScheduler()));
+            return;
+        } else if (m_fd_type != QSocketNotifier::Read
+                   && m_discover->listen_fd() >= 0) {
+            registerNotify(m_discover->listen_fd(),
+                           QSocketNotifier::Read, SLOT(slotCheckScheduler()));
+        }
+        if (m_fd_type == QSocketNotifier::Read) {
+            QTimer::singleShot(1000 + (qrand() & 1023), this, SLOT(slotCheckScheduler()));
+        }
+    }
+
+    setOnline(false);
+}
+
+void SchedulerConnection::msgReceived()
+{
+    while (!m_scheduler->read_a_bit() || m_scheduler->has_msg())
+        if (!handleActivity()) {
+            break;
+        }
+}
+
+bool SchedulerConnection::handleActivity()
+{
+    Msg *m = m_scheduler->get_msg();
+    if (!m) {
+        checkScheduler(true);
+        return false;
+    }
+
+    if (m->type == M_END) {
+        std::cout << "END" << endl;
+        delete m;
+        checkScheduler(true);
+        return false;
+    }
+
+    handleMessage(m);
+    delete m;
+    return true;
+}
+
+void SchedulerConnection::handleMessage(Msg *_m)
+{
+    switch (_m->type) {
+    case M_MON_GET_CS:
+        if (MonGetCSMsg *m = dynamic_cast<MonGetCSMsg *>(_m)) {
+            MonitorEvent event(MonitorEvent::JobRequested);
+            event.jobId = m->job_id;
+            event.hostId = m->clientid;
+            event.fileName = QString::fromStdString(m->filename);
+            event.lang = (m->lang == CompileJob::Lang_C ? Job::Lang_C : Job::Lang_CXX);
+            postEvent(std::move(event));
+        }
+        break;
+    case M_MON_JOB_BEGIN:
+        if (MonJobBeginMsg *m = dynamic_cast<MonJobBeginMsg *>(_m)) {
+            MonitorEvent event(MonitorEvent::JobBegin);
+            event.jobId = m->job_id;
+            event.hostId = m->hostid;
+            event.startTime = m->stime;
+            postEvent(std::move(event));
+        }
+        break;
+    case M_MON_JOB_DONE:
+        if (MonJobDoneMsg *m = dynamic_cast<MonJobDoneMsg *>(_m)) {
+            MonitorEvent event(MonitorEvent::JobDone);
+            event.jobId = m->job_id;
+            event.exitcode = m->exitcode;
+            event.real_msec = m->real_msec;
+            event.user_msec = m->user_msec;
+            event.sys_msec = m->sys_msec;
+            event.pfaults = m->pfaults;
+            event.in_compressed = m->in_compressed;
+            event.in_uncompressed = m->in_uncompressed;
+            event.out_compressed = m->out_compressed;
+            event.out_uncompressed = m->out_uncompressed;
+            postEvent(std::move(event));
+        }
+        break;
+    case M_MON_STATS:
+        if (MonStatsMsg *m = dynamic_cast<MonStatsMsg *>(_m)) {
+            MonitorEvent event(MonitorEvent::HostStats);
+            event.hostId = m->hostid;
+            // the only copy, everything else is parsed in place
+            event.stats = HostStats(QByteArray(m->statmsg.data(), int(m->statmsg.size())));
+            postEvent(std::move(event));
+        }
+        break;
+    case M_MON_LOCAL_JOB_BEGIN:
+        if (MonLocalJobBeginMsg *m = dynamic_cast<MonLocalJobBeginMsg *>(_m)) {
+            MonitorEvent event(MonitorEvent::LocalJobBegin);
+            event.jobId = m->job_id;
+            event.hostId = m->hostid;
+            event.fileName = QString::fromStdString(m->file);
+            event.lang = Job::Lang_CXX;
+            postEvent(std::move(event));
+        }
+        break;
+    case M_JOB_LOCAL_DONE:
+        if (JobLocalDoneMsg *m = dynamic_cast<JobLocalDoneMsg *>(_m)) {
+            MonitorEvent event(MonitorEvent::LocalJobDone);
+            event.jobId = m->job_id;
+            postEvent(std::move(event));
+        }
+        break;
+    default:
+        cout << "UNKNOWN" << endl;
+        break;
+    }
+}
@@ -0,0 +1,96 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2003 Frerich Raabe <raabe@kde.org>
+    Copyright (c) 2003,2004 Stephan Kulow <coolo@kde.org>
+    Copyright (c) 2003,2004 Cornelius Schumacher <schumacher@kde.org>
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_SCHEDULERCONNECTION_H
+#define ICEMON_SCHEDULERCONNECTION_H
+
+#include "monitorevent.h"
+#include "spscqueue.h"
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QObject>
+#include <QSocketNotifier>
+
+class DiscoverSched;
+class Msg;
+class MsgChannel;
+
+/**
+ * Owns the connection to the icecream scheduler
+ *
+ * Lives in a dedicated thread: discovers the scheduler, reads and decodes
+ * monitor messages and hands them over as MonitorEvent instances through a
+ * single-producer/single-consumer queue.
+ *
+ * The consumer is notified via eventsAvailable() once per batch; it has to
+ * call acknowledgeEvents() before draining the queue with takeEvent().
+ */
+class SchedulerConnection
+    : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SchedulerConnection(QObject *parent = nullptr);
+    ~SchedulerConnection();
+
+    /// Consumer side, may be called from any (single) thread
+    bool takeEvent(MonitorEvent *event);
+    void acknowledgeEvents();
+
+public Q_SLOTS:
+    void start();
+    void setNetname(const QByteArray &netname);
+    void setSchedname(const QByteArray &schedname);
+
+Q_SIGNALS:
+    void eventsAvailable();
+
+private Q_SLOTS:
+    void slotCheckScheduler();
+    void msgReceived();
+
+private:
+    void checkScheduler(bool deleteit = false);
+    void registerNotify(int fd, QSocketNotifier::Type type, const char *slot);
+
+    bool handleActivity();
+    void handleMessage(Msg *m);
+    void postEvent(MonitorEvent &&event);
+    void setOnline(bool online);
+
+    SpscQueue<MonitorEvent> m_events;
+    QAtomicInt m_notificationPending;
+
+    MsgChannel *m_scheduler;
+    DiscoverSched *m_discover;
+    QSocketNotifier *m_fd_notify;
+    QSocketNotifier::Type m_fd_type;
+    bool m_online;
+
+    QByteArray m_netname;
+    QByteArray m_schedname;
+};
+
+#endif // ICEMON_SCHEDULERCONNECTION_H
@@ -0,0 +1,97 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_SPSCQUEUE_H
+#define ICEMON_SPSCQUEUE_H
+
+#include <QAtomicInt>
+#include <QVector>
+
+#include <utility>
+
+/**
+ * Bounded, lock-free queue for exactly one producer and one consumer thread
+ *
+ * The capacity is rounded up to the next power of two; one slot is kept free
+ * to tell a full queue from an empty one.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(int capacity = 4096)
+        : m_head(0)
+        , m_tail(0)
+    {
+        int size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_buffer.resize(size);
+        m_data = m_buffer.data();
+        m_mask = size - 1;
+    }
+
+    /// Producer side: returns false if the queue is full
+    bool tryPush(T &&value)
+    {
+        const int head = m_head.load();
+        const int next = (head + 1) & m_mask;
+        if (next == m_tail.loadAcquire()) {
+            return false;
+        }
+
+        m_data[head] = std::move(value);
+        m_head.storeRelease(next);
+        return true;
+    }
+
+    /// Consumer side: returns false if the queue is empty
+    bool tryPop(T *value)
+    {
+        const int tail = m_tail.load();
+        if (tail == m_head.loadAcquire()) {
+            return false;
+        }
+
+        *value = std::move(m_data[tail]);
+        m_tail.storeRelease((tail + 1) & m_mask);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_tail.loadAcquire() == m_head.loadAcquire();
+    }
+
+private:
+    Q_DISABLE_COPY(SpscQueue)
+
+    QVector<T> m_buffer;
+    T *m_data;
+    int m_mask;
+
+    // written by the producer only
+    QAtomicInt m_head;
+    // written by the consumer only
+    QAtomicInt m_tail;
+};
+
+#endif // ICEMON_SPSCQUEUE_H
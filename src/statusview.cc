@@ -30,6 +30,13 @@
 #include <QDebug>
 #include <QTime>
 
+namespace {
+
+/// Number of finished jobs replayed into views which remember jobs
+const int MAX_REPLAYED_JOBS = 3000;
+
+}
+
 StatusView::StatusView(QObject *parent)
     : QObject(parent)
     , m_paused(false)
@@ -57,9 +64,11 @@ void StatusView::setMonitor(Monitor *monitor)
     }
 
     if (m_monitor) {
-        disconnect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(update(Job)));
+        disconnect(m_monitor.data(), SIGNAL(jobsUpdated(QVector<Job>)), this, SLOT(updateJobs(QVector<Job>)));
         disconnect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNode(HostId)));
         disconnect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+        disconnect(m_monitor->hostInfoManager(), SIGNAL(hostChanged(HostId,HostInfo::Fields)),
+                   this, SLOT(updateHost(HostId,HostInfo::Fields)));
         disconnect(m_monitor.data(), SIGNAL(schedulerStateChanged(Monitor::SchedulerState)),
                    this, SLOT(updateSchedulerState(Monitor::SchedulerState)));
     }
@@ -67,16 +76,30 @@ void StatusView::setMonitor(Monitor *monitor)
     m_monitor = monitor;
 
     if (m_monitor) {
-        connect(m_monitor.data(), SIGNAL(jobUpdated(Job)), this, SLOT(update(Job)));
+        connect(m_monitor.data(), SIGNAL(jobsUpdated(QVector<Job>)), this, SLOT(updateJobs(QVector<Job>)));
         connect(m_monitor.data(), SIGNAL(nodeRemoved(HostId)), this, SLOT(removeNode(HostId)));
-        connect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+        if (hostFields()) {
+            connect(m_monitor->hostInfoManager(), SIGNAL(hostChanged(HostId,HostInfo::Fields)),
+                    this, SLOT(updateHost(HostId,HostInfo::Fields)));
+        } else {
+            connect(m_monitor.data(), SIGNAL(nodeUpdated(HostId)), this, SLOT(checkNode(HostId)));
+        }
         connect(m_monitor.data(), SIGNAL(schedulerStateChanged(Monitor::SchedulerState)),
                 this, SLOT(updateSchedulerState(Monitor::SchedulerState)));
 
         if (options().testFlag(RememberJobsOption)) {
-            foreach(const Job &job, m_monitor->jobHistory()) {
-                update(job);
+            const JobHistory &history = m_monitor->jobHistory();
+            const JobList active = m_monitor->activeJobs();
+            const int first = qMax(0, history.size() - MAX_REPLAYED_JOBS);
+            QVector<Job> jobs;
+            jobs.reserve(history.size() - first + active.size());
+            for (int i = first; i < history.size(); ++i) {
+                jobs.append(history.at(i));
             }
+            foreach(const Job &job, active) {
+                jobs.append(job);
+            }
+            updateJobs(jobs);
         }
     }
 }
@@ -90,10 +113,29 @@ void StatusView::update(const Job &)
 {
 }
 
+void StatusView::updateJobs(const QVector<Job> &jobs)
+{
+    foreach(const Job &job, jobs) {
+        update(job);
+    }
+}
+
+HostInfo::Fields StatusView::hostFields() const
+{
+    return HostInfo::Fields();
+}
+
 void StatusView::checkNode(HostId)
 {
 }
 
+void StatusView::updateHost(HostId hostid, HostInfo::Fields fields)
+{
+    if (fields & hostFields()) {
+        checkNode(hostid);
+    }
+}
+
 void StatusView::removeNode(HostId)
 {
 }
@@ -23,13 +23,14 @@
 #ifndef ICEMON_STATUSVIEW_H
 #define ICEMON_STATUSVIEW_H
 
+#include "hostinfo.h"
 #include "monitor.h"
 #include "types.h"
 
 #include <QObject>
 #include <QPointer>
+#include <QVector>
 
-class HostInfoManager;
 class Job;
 
 class QColor;
@@ -73,6 +74,13 @@ public:
 
     virtual QString id() const = 0;
 
+    /**
+     * Host fields shown by the view, checkNode() is only called when one of
+     * them changes. The default, no fields, calls checkNode() for every host
+     * update of the monitor, even if nothing changed.
+     */
+    virtual HostInfo::Fields hostFields() const;
+
     unsigned int processor(const Job &);
 
     QString nameForHost(unsigned int hostid);
@@ -80,7 +88,10 @@ public:
 
 protected Q_SLOTS:
     virtual void update(const Job &job);
+    /// Default implementation calls update() for each job
+    virtual void updateJobs(const QVector<Job> &jobs);
     virtual void checkNode(HostId hostid);
+    void updateHost(HostId hostid, HostInfo::Fields fields);
     virtual void removeNode(HostId hostid);
     virtual void updateSchedulerState(Monitor::SchedulerState state);
 
@@ -0,0 +1,142 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "timingwheel.h"
+
+TimingWheel::TimingWheel(uint now)
+    : m_current(now)
+    , m_count(0)
+{
+}
+
+void TimingWheel::clear(uint now)
+{
+    for (int level = 0; level < LevelCount; ++level) {
+        for (int i = 0; i < SlotCount; ++i) {
+            m_slots[level][i].clear();
+        }
+    }
+    m_overflow.clear();
+    m_due.clear();
+    m_current = now;
+    m_count = 0;
+}
+
+void TimingWheel::insert(uint expiry, unsigned int id)
+{
+    place(Entry(expiry, id));
+    ++m_count;
+}
+
+void TimingWheel::place(const Entry &entry)
+{
+    if (entry.expiry < m_current) {
+        m_due.append(entry);
+        return;
+    }
+
+    const uint expiry = entry.expiry;
+    const uint delta = expiry - m_current;
+
+    for (int level = 0; level < LevelCount; ++level) {
+        const int shift = level * SlotBits;
+        if (delta < (1u << (shift + SlotBits))) {
+            m_slots[level][(expiry >> shift) & SlotMask].append(entry);
+            return;
+        }
+    }
+
+    m_overflow.append(entry);
+}
+
+void TimingWheel::cascade(Slot *slot)
+{
+    Slot entries;
+    entries.swap(*slot);
+    foreach(const Entry &entry, entries) {
+        place(entry);
+    }
+}
+
+QVector<unsigned int> TimingWheel::advance(uint now)
+{
+    QVector<unsigned int> expired;
+    if (m_count == 0) {
+        m_current = qMax(m_current, now + 1);
+        return expired;
+    }
+
+    foreach(const Entry &entry, m_due) {
+        expired << entry.id;
+    }
+    m_due.clear();
+
+    if (now < m_current) {
+        m_count -= expired.size();
+        return expired;
+    }
+
+    // After long pauses (e.g. suspend) walking tick by tick is pointless
+    if (now - m_current >= SlotCount * SlotCount) {
+        Slot remaining;
+        for (int level = 0; level < LevelCount; ++level) {
+            for (int i = 0; i < SlotCount; ++i) {
+                remaining << m_slots[level][i];
+                m_slots[level][i].clear();
+            }
+        }
+        remaining << m_overflow;
+        m_overflow.clear();
+
+        m_current = now + 1;
+        foreach(const Entry &entry, remaining) {
+            if (entry.expiry <= now) {
+                expired << entry.id;
+            } else {
+                place(entry);
+            }
+        }
+        m_count -= expired.size();
+        return expired;
+    }
+
+    for (; m_current <= now; ++m_current) {
+        const uint tick = m_current;
+        if ((tick & SlotMask) == 0) {
+            // refill the lower levels, highest level first
+            if ((tick & ((1u << (2 * SlotBits)) - 1)) == 0) {
+                if ((tick & ((1u << (3 * SlotBits)) - 1)) == 0) {
+                    cascade(&m_overflow);
+                }
+                cascade(&m_slots[2][(tick >> (2 * SlotBits)) & SlotMask]);
+            }
+            cascade(&m_slots[1][(tick >> SlotBits) & SlotMask]);
+        }
+
+        Slot &slot = m_slots[0][tick & SlotMask];
+        foreach(const Entry &entry, slot) {
+            expired << entry.id;
+        }
+        slot.clear();
+    }
+
+    m_count -= expired.size();
+    return expired;
+}
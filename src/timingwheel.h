@@ -0,0 +1,79 @@
+/*
+    This file is part of Icecream.
+
+    Copyright (c) 2017 The Icecream developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef ICEMON_TIMINGWHEEL_H
+#define ICEMON_TIMINGWHEEL_H
+
+#include <QVector>
+
+/**
+ * Hierarchical timing wheel for ids expiring at integral ticks
+ *
+ * Three levels of 64 slots each cover 64^3 ticks ahead, anything further
+ * out waits in an overflow list. Inserting is O(1), advancing costs O(1)
+ * per elapsed tick plus the number of expired or cascaded entries.
+ */
+class TimingWheel
+{
+public:
+    explicit TimingWheel(uint now = 0);
+
+    /// Schedule @p id to expire at tick @p expiry
+    void insert(uint expiry, unsigned int id);
+
+    /// Advance the wheel to @p now and return the ids expired in the meantime, oldest first
+    QVector<unsigned int> advance(uint now);
+
+    bool isEmpty() const { return m_count == 0; }
+    int size() const { return m_count; }
+
+    void clear(uint now = 0);
+
+private:
+    enum {
+        SlotBits = 6,
+        SlotCount = 1 << SlotBits,
+        SlotMask = SlotCount - 1,
+        LevelCount = 3
+    };
+
+    struct Entry
+    {
+        Entry(uint expiry = 0, unsigned int id = 0)
+            : expiry(expiry)
+            , id(id) {}
+        uint expiry;
+        unsigned int id;
+    };
+    using Slot = QVector<Entry>;
+
+    void place(const Entry &entry);
+    void cascade(Slot *slot);
+
+    Slot m_slots[LevelCount][SlotCount];
+    Slot m_overflow;
+    /// Entries inserted with an expiry which has already been processed
+    Slot m_due;
+    /// The next tick which has not been processed yet
+    uint m_current;
+    int m_count;
+};
+
+#endif // ICEMON_TIMINGWHEEL_H
@@ -29,6 +29,7 @@
 #include "joblistview.h"
 #include "hostinfo.h"
 #include "hostlistview.h"
+#include "monitor.h"
 #include "models/joblistmodel.h"
 #include "models/hostlistmodel.h"
 
@@ -89,6 +90,9 @@ DetailedHostView::DetailedHostView(QObject *parent)
     mLocalJobsView->setModel(mSortedLocalJobsModel);
     mLocalJobsView->setClientColumnVisible(false);
     dummy->addWidget(mLocalJobsView);
+    mLocalStatsLabel = new QLabel(locals);
+    mLocalStatsLabel->setToolTip(tr("Percentiles of the duration of finished jobs sent by this host"));
+    dummy->addWidget(mLocalStatsLabel);
 
     auto remotes = new QWidget(viewSplitter);
     dummy = new QVBoxLayout(remotes);
@@ -107,6 +111,9 @@ DetailedHostView::DetailedHostView(QObject *parent)
     mRemoteJobsView->setModel(mSortedRemoteJobsModel);
     mRemoteJobsView->setServerColumnVisible(false);
     dummy->addWidget(mRemoteJobsView);
+    mRemoteStatsLabel = new QLabel(remotes);
+    mRemoteStatsLabel->setToolTip(tr("Percentiles of the duration of finished jobs compiled by this host"));
+    dummy->addWidget(mRemoteStatsLabel);
 
     createKnownHosts();
 }
@@ -120,6 +127,7 @@ void DetailedHostView::setMonitor(Monitor *monitor)
     mRemoteJobsModel->setMonitor(monitor);
 
     createKnownHosts();
+    updateStatistics();
 }
 
 void DetailedHostView::checkNode(unsigned int hostid)
@@ -142,9 +150,8 @@ void DetailedHostView::createKnownHosts()
         return;
     }
 
-    const HostInfoManager::HostMap hosts(hostInfoManager()->hostMap());
-    foreach(int hostid, hosts.keys()) {
-        checkNode(hostid);
+    foreach(const HostInfo *host, hostInfoManager()->hosts()) {
+        checkNode(host->id());
     }
 }
 
@@ -155,6 +162,36 @@ void DetailedHostView::slotNodeActivated()
         return;
     mLocalJobsModel->setHostId(hostid);
     mRemoteJobsModel->setHostId(hostid);
+    updateStatistics();
+}
+
+void DetailedHostView::updateJobs(const QVector<Job> &jobs)
+{
+    StatusView::updateJobs(jobs);
+
+    const unsigned int hostid = mLocalJobsModel->hostId();
+    foreach(const Job &job, jobs) {
+        if (job.isDone() && (job.client == hostid || job.server == hostid)) {
+            updateStatistics();
+            break;
+        }
+    }
+}
+
+void DetailedHostView::updateStatistics()
+{
+    const unsigned int hostid = mLocalJobsModel->hostId();
+    const JobStatistics::Histograms *sent = nullptr;
+    const JobStatistics::Histograms *compiled = nullptr;
+    if (monitor() && hostid) {
+        sent = monitor()->jobStatistics().client(hostid);
+        compiled = monitor()->jobStatistics().server(hostid);
+    }
+
+    mLocalStatsLabel->setText(tr("Duration: %1").arg(
+        sent ? JobStatistics::durationSummary(sent->realTime) : tr("n/a")));
+    mRemoteStatsLabel->setText(tr("Duration: %1").arg(
+        compiled ? JobStatistics::durationSummary(compiled->realTime) : tr("n/a")));
 }
 
 QWidget *DetailedHostView::widget() const
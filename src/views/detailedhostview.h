@@ -27,6 +27,7 @@
 #include <QWidget>
 
 class HostListModel;
+class QLabel;
 class JobListView;
 class JobListModel;
 class HostListView;
@@ -49,11 +50,15 @@ public:
 
     void checkNode(unsigned int hostid) override;
 
+protected slots:
+    void updateJobs(const QVector<Job> &jobs) override;
+
 private slots:
     void slotNodeActivated();
 
 private:
     void createKnownHosts();
+    void updateStatistics();
 
     QScopedPointer<QWidget> m_widget;
 
@@ -64,10 +69,12 @@ private:
     JobListModel *mLocalJobsModel;
     JobListView *mLocalJobsView;
     JobListSortFilterProxyModel *mSortedLocalJobsModel;
+    QLabel *mLocalStatsLabel;
 
     JobListModel *mRemoteJobsModel;
     JobListView *mRemoteJobsView;
     JobListSortFilterProxyModel *mSortedRemoteJobsModel;
+    QLabel *mRemoteStatsLabel;
 };
 
 #endif
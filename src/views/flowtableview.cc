@@ -20,125 +20,221 @@
 
 #include "flowtableview.h"
 
+#include "models/flowtablemodel.h"
+
 #include <QHeaderView>
-#include <QIcon>
 #include <QDebug>
 #include <QPainter>
+#include <QSortFilterProxyModel>
 #include <QTimer>
 
-ProgressWidget::ProgressWidget(HostInfo *info, StatusView *statusView, QWidget *parent)
-    : QWidget(parent)
-    , m_hostInfo(info)
-    , m_statusView(statusView)
-    , m_isVirgin(true)
+#include <algorithm>
+
+namespace {
+
+const int UPDATE_INTERVAL_MSEC = 50;
+
+}
+
+FlowHistory::FlowHistory(const QColor &baseColor)
+    : m_head(0)
+    , m_baseColor(baseColor)
 {
-    setAutoFillBackground(false);
-    setAttribute(Qt::WA_OpaquePaintEvent);
-    setAttribute(Qt::WA_NoSystemBackground);
-    m_backingStore = QImage(size(), QImage::Format_RGB32);
-    m_backingStore.fill(palette().base().color().rgb());
+    // fades the color of the jobs in from the top of the cell
+    QLinearGradient gradient(0, 0, 0, 1);
+    gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
+    QColor transparent = baseColor;
+    transparent.setAlpha(0);
+    gradient.setColorAt(0, baseColor);
+    gradient.setColorAt(1, transparent);
+    m_overlay = QBrush(gradient);
 }
 
-void ProgressWidget::paintEvent(QPaintEvent *)
+void FlowHistory::clear()
 {
-    QImage temp(size(), QImage::Format_RGB32);
-    QPainter p(&temp);
+    m_image = QImage();
+    m_head = 0;
+    m_colors.clear();
+    m_freeLines.clear();
+}
 
-    p.drawImage(-1, 0, m_backingStore);
+int FlowHistory::addLine()
+{
+    if (m_freeLines.isEmpty()) {
+        const int lines = m_colors.size();
+        const int newLines = qMax(8, 2 * lines);
+        resize(m_image.width(), newLines);
+        m_colors.resize(newLines);
+        for (int i = newLines - 1; i >= lines; --i) {
+            m_colors[i] = m_baseColor.rgb();
+            m_freeLines.append(i);
+        }
+    }
 
-    if (m_isVirgin) {
-        p.fillRect(rect(), palette().base());
-        m_isVirgin = false;
+    const int line = m_freeLines.last();
+    m_freeLines.removeLast();
+    return line;
+}
+
+void FlowHistory::removeLine(int line)
+{
+    // wipe it, so that the next host starts out empty
+    m_colors[line] = m_baseColor.rgb();
+    if (!m_image.isNull()) {
+        QRgb *pixels = reinterpret_cast<QRgb *>(m_image.scanLine(line));
+        std::fill(pixels, pixels + m_image.width(), m_baseColor.rgb());
     }
+    m_freeLines.append(line);
+}
 
-    if (m_currentJob.state == Job::Compiling ||
-        m_currentJob.state == Job::LocalOnly) {
-        QLinearGradient gradient;
-        gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
-        gradient.setColorAt(0, palette().base().color());
-        gradient.setColorAt(1, m_statusView->hostColor(m_currentJob.client));
-        p.fillRect(width() - 1, 0, 1, height(), gradient);
-    } else {
-        p.fillRect(width() - 1, 0, 1, height(), palette().base().color());
+void FlowHistory::setColor(int line, const QColor &color)
+{
+    m_colors[line] = color.rgb();
+}
+
+void FlowHistory::ensureCapacity(int columns)
+{
+    if (columns > m_image.width()) {
+        // grow in steps, resizing the column should not reallocate every time
+        resize(qMax(columns, m_image.width() + m_image.width() / 2), m_colors.size());
     }
+}
 
-    QPainter screenp(this);
-    screenp.drawImage(0, 0, temp);
-    m_backingStore = temp;
+void FlowHistory::advance()
+{
+    if (m_image.isNull()) {
+        return;
+    }
+
+    m_head = (m_head + 1) % m_image.width();
+    uchar *bits = m_image.bits();
+    const int bytesPerLine = m_image.bytesPerLine();
+    for (int line = 0; line < m_colors.size(); ++line) {
+        reinterpret_cast<QRgb *>(bits + line * bytesPerLine)[m_head] = m_colors.at(line);
+    }
 }
 
-void ProgressWidget::resizeEvent(QResizeEvent *) {
-    m_isVirgin = true;
+void FlowHistory::paint(QPainter *p, const QRect &rect, int line) const
+{
+    const int columns = qMin(rect.width(), m_image.width());
+    if (columns < rect.width()) {
+        p->fillRect(rect.x(), rect.y(), rect.width() - columns, rect.height(), m_baseColor);
+    }
+    drawRing(p, rect, line, 1);
+    p->fillRect(rect, m_overlay);
+}
+
+void FlowHistory::drawRing(QPainter *p, const QRect &rect, int line, int lineCount) const
+{
+    if (m_image.isNull()) {
+        return;
+    }
+
+    const int columns = qMin(rect.width(), m_image.width());
+    const int right = rect.x() + rect.width();
+
+    // the newest columns up to the head, then the older ones from the end
+    const int newer = qMin(columns, m_head + 1);
+    p->drawImage(QRect(right - newer, rect.y(), newer, rect.height()),
+                 m_image, QRect(m_head + 1 - newer, line, newer, lineCount));
+    const int older = columns - newer;
+    if (older > 0) {
+        p->drawImage(QRect(right - columns, rect.y(), older, rect.height()),
+                     m_image, QRect(m_image.width() - older, line, older, lineCount));
+    }
+}
+
+void FlowHistory::resize(int columns, int lines)
+{
+    QImage image(columns, lines, QImage::Format_RGB32);
+    image.fill(m_baseColor.rgb());
+    if (!m_image.isNull() && !image.isNull()) {
+        // linearize, the newest tick ends up in the last column
+        QPainter p(&image);
+        drawRing(&p, QRect(0, 0, columns, m_image.height()), 0, m_image.height());
+    }
+    m_image = image;
+    m_head = columns - 1;
+}
+
+FlowHistoryDelegate::FlowHistoryDelegate(FlowHistory *history, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_history(history)
+{
+}
+
+void FlowHistoryDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const int line = index.data(FlowTableModel::HistoryLineRole).toInt();
+    m_history->paint(painter, option.rect, line);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 FlowTableView::FlowTableView(QObject *parent)
     : StatusView(parent)
-    , m_updateTimer(new QTimer)
-    , m_widget(new QTableWidget)
-{
-    m_widget->setColumnCount(4);
-    QStringList labels;
-    labels << tr("Host") << tr("File") << tr("History") << tr("State");
-    m_widget->setHorizontalHeaderLabels(labels);
-    m_widget->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    , m_widget(new QTableView)
+    , m_model(new FlowTableModel(this))
+    , m_sortedModel(new QSortFilterProxyModel(this))
+    , m_updateTimer(new QTimer(this))
+{
+    m_history.reset(new FlowHistory(m_widget->palette().base().color()));
+
+    m_sortedModel->setDynamicSortFilter(true);
+    m_sortedModel->setSortRole(FlowTableModel::SortRole);
+    m_sortedModel->setSourceModel(m_model);
+
+    m_widget->setModel(m_sortedModel);
+    m_widget->setItemDelegateForColumn(FlowTableModel::ColumnHistory,
+                                       new FlowHistoryDelegate(m_history.data(), m_widget.data()));
+    m_widget->horizontalHeader()->setSectionResizeMode(FlowTableModel::ColumnHistory, QHeaderView::Stretch);
+    // rows have the same height, so the view does not have to measure them
+    m_widget->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     m_widget->verticalHeader()->hide();
     m_widget->setSelectionMode(QAbstractItemView::NoSelection);
+    m_widget->setSortingEnabled(true);
+    m_widget->sortByColumn(FlowTableModel::ColumnHost, Qt::AscendingOrder);
 
-    m_updateTimer->setInterval(50);
+    connect(m_updateTimer, SIGNAL(timeout()), SLOT(advanceHistory()));
+    m_updateTimer->setInterval(UPDATE_INTERVAL_MSEC);
     m_updateTimer->start();
 }
 
+void FlowTableView::setMonitor(Monitor *monitor)
+{
+    StatusView::setMonitor(monitor);
+
+    m_model->setHostInfoManager(hostInfoManager());
+    m_history->clear();
+
+    if (hostInfoManager()) {
+        const HostSnapshot hosts = hostInfoManager()->hosts();
+        for (HostSnapshot::ConstIterator it = hosts.constBegin(); it != hosts.constEnd(); ++it) {
+            checkNode((*it)->id());
+        }
+    }
+}
+
 void FlowTableView::update(const Job &job)
 {
-    int serverId = job.server;
+    HostId serverId = job.server;
     if (serverId == 0) {
         return;
     }
 
     // checkNode hasn't been run for this server yet.
-    if (!m_idToRowMap.contains(serverId)) {
+    const int line = m_model->historyLine(serverId);
+    if (line < 0) {
         return;
     }
 
-    int serverRow = m_idToRowMap.value(serverId);
-    QTableWidgetItem *fileNameItem = m_widget->item(serverRow, 1);
-    QTableWidgetItem *jobStateItem = m_widget->item(serverRow, 3);
-
-    if (job.state == Job::Finished) {
-        fileNameItem->setText(QLatin1String(""));
-        jobStateItem->setText(QLatin1String(""));
+    if (job.state == Job::Compiling || job.state == Job::LocalOnly) {
+        m_history->setColor(line, hostColor(job.client));
     } else {
-        QString filePath = job.fileName;
-        QString fileName = filePath.mid(filePath.lastIndexOf(QLatin1Char('/')) + 1);
-        fileNameItem->setText(fileName);
-        fileNameItem->setToolTip(job.fileName);
-        fileNameItem->setFlags(Qt::ItemIsEnabled);
-        jobStateItem->setText(job.stateAsString());
-        jobStateItem->setToolTip(job.stateAsString());
-        jobStateItem->setFlags(Qt::ItemIsEnabled);
+        m_history->clearColor(line);
     }
 
-    if (ProgressWidget * progressWidget = static_cast<ProgressWidget *>(m_widget->cellWidget(serverRow, 2))) {
-        progressWidget->setCurrentJob(job);
-    }
-
-    // update the host column for the server requesting the job
-    QTableWidgetItem *hostNameItem = m_widget->item(serverRow, 0);
-    int usageCount = hostNameItem->data(Qt::UserRole).toInt();
-    if (job.state == Job::LocalOnly || job.state == Job::Compiling) {
-        ++usageCount;
-    } else if (job.state == Job::Finished || job.state == Job::Failed) {
-        --usageCount;
-    }
-
-    hostNameItem->setData(Qt::UserRole, usageCount);
-
-    QFont f = m_widget->font();
-    f.setBold(usageCount > 0);
-    hostNameItem->setFont(f);
-    hostNameItem->setText(hostInfoText(hostInfoManager()->find(serverId), usageCount));
+    m_model->updateJob(job);
 }
 
 QWidget *FlowTableView::widget() const
@@ -146,51 +242,49 @@ QWidget *FlowTableView::widget() const
     return m_widget.data();
 }
 
-QString FlowTableView::hostInfoText(HostInfo *hostInfo, int runningProcesses) {
-    if (hostInfo->serverSpeed() == 0) { // host disabled
-        return tr("%1 (Disabled)").arg(hostInfo->name());
-    } else {
-        return tr("%1 (%2/%3)").arg(hostInfo->name()).arg(runningProcesses).arg(hostInfo->maxJobs());
-    }
+HostInfo::Fields FlowTableView::hostFields() const
+{
+    // the host column, a speed of 0 shows the host as disabled
+    return HostInfo::AddedField | HostInfo::NameField | HostInfo::ColorField | HostInfo::MaxJobsField
+           | HostInfo::SpeedField;
 }
 
 void FlowTableView::checkNode(unsigned int hostId)
 {
-    if (m_idToRowMap.contains(hostId)) {
+    if (m_model->contains(hostId)) {
+        m_model->updateHost(hostId);
+        return;
+    }
+    if (!hostInfoManager() || !hostInfoManager()->find(hostId)) {
         return;
     }
 
-    HostInfo *hostInfo = hostInfoManager()->hostMap().value(hostId);
-    QTableWidgetItem *widgetItem = new QTableWidgetItem(hostInfoText(hostInfo));
-    widgetItem->setIcon(QIcon(QStringLiteral(":/images/icemonnode.png")));
-    widgetItem->setToolTip(hostInfo->toolTip());
-    widgetItem->setBackgroundColor(hostInfo->color());
-    // usage count
-    widgetItem->setData(Qt::UserRole, 0);
-    widgetItem->setFlags(Qt::ItemIsEnabled);
-    int insertRow = m_widget->rowCount();
-    m_widget->setRowCount(insertRow + 1);
-    m_idToRowMap.insert(hostId, insertRow);
-    m_widget->setItem(insertRow, 0, widgetItem);
-    // adjust column width
-    int width = QFontMetrics(widgetItem->font()).width(widgetItem->text()) + 32;
-    m_widget->horizontalHeader()->resizeSection(0, qMax(m_widget->horizontalHeader()->sectionSize(0), width));
-
-    widgetItem = new QTableWidgetItem;
-    widgetItem->setFlags(Qt::ItemIsEnabled);
-    m_widget->setItem(insertRow, 1, widgetItem);
+    m_model->addHost(hostId, m_history->addLine());
 
-    widgetItem = new QTableWidgetItem;
-    widgetItem->setFlags(Qt::ItemIsEnabled);
-    m_widget->setItem(insertRow, 3, widgetItem);
+    // adjust column width
+    QFont font = m_widget->font();
+    font.setBold(true);
+    const int width = QFontMetrics(font).width(m_model->hostText(hostId)) + 32;
+    QHeaderView *header = m_widget->horizontalHeader();
+    header->resizeSection(FlowTableModel::ColumnHost, qMax(header->sectionSize(FlowTableModel::ColumnHost), width));
+}
 
-    auto pw = new ProgressWidget(hostInfo, this);
-    connect(m_updateTimer, SIGNAL(timeout()), pw, SLOT(update()));
-    m_widget->setCellWidget(insertRow, 2, pw);
+void FlowTableView::advanceHistory()
+{
+    QHeaderView *header = m_widget->horizontalHeader();
+    m_history->ensureCapacity(header->sectionSize(FlowTableModel::ColumnHistory));
+    m_history->advance();
+
+    // only the visible rows of the column are painted
+    m_widget->viewport()->update(header->sectionViewportPosition(FlowTableModel::ColumnHistory), 0,
+                                 header->sectionSize(FlowTableModel::ColumnHistory),
+                                 m_widget->viewport()->height());
 }
 
 void FlowTableView::removeNode(unsigned int hostId)
 {
-    m_widget->removeRow(m_idToRowMap.value(hostId));
-    m_idToRowMap.remove(hostId);
+    const int line = m_model->removeHost(hostId);
+    if (line >= 0) {
+        m_history->removeLine(line);
+    }
 }
@@ -25,32 +25,76 @@
 #include "hostinfo.h"
 #include "statusview.h"
 
+#include <QBrush>
+#include <QImage>
 #include <QScopedPointer>
-#include <QTableWidget>
-#include <QTableWidgetItem>
+#include <QStyledItemDelegate>
+#include <QTableView>
+#include <QVector>
 
+class FlowTableModel;
 class Job;
 
-typedef QHash<int, int> HostIdRowMap;
+class QSortFilterProxyModel;
 
-class ProgressWidget
-    : public QWidget
+/**
+ * Contents of the History column of all hosts in one ring image
+ *
+ * Each host owns one line of the image, one pixel holds the color of one
+ * tick. advance() moves the write position by one column and writes the
+ * current color of every line, so a tick costs one pixel per host. Painting
+ * stretches a line to the height of its cell with at most two blits and
+ * lays a gradient on top, so that jobs fade in from the top of the cell.
+ */
+class FlowHistory
+{
+public:
+    explicit FlowHistory(const QColor &baseColor);
+
+    /// Forget all lines
+    void clear();
+
+    /// @return the line of the new host
+    int addLine();
+    void removeLine(int line);
+
+    /// Color written for @p line on the following ticks
+    void setColor(int line, const QColor &color);
+    void clearColor(int line) { setColor(line, m_baseColor); }
+
+    /// Keep at least @p columns ticks, e.g. after the column got wider
+    void ensureCapacity(int columns);
+    void advance();
+
+    /// Draw @p line into @p rect, the newest tick at the right edge
+    void paint(QPainter *p, const QRect &rect, int line) const;
+
+private:
+    void drawRing(QPainter *p, const QRect &rect, int line, int lineCount) const;
+    void resize(int columns, int lines);
+
+    QImage m_image;
+    int m_head;                 ///< column of the newest tick
+    QVector<QRgb> m_colors;     ///< per line
+    QVector<int> m_freeLines;
+    QColor m_baseColor;
+    QBrush m_overlay;
+
+    Q_DISABLE_COPY(FlowHistory)
+};
+
+/// Paints the History column from a FlowHistory
+class FlowHistoryDelegate
+    : public QStyledItemDelegate
 {
     Q_OBJECT
 public:
-    ProgressWidget(HostInfo *info, StatusView *statusView, QWidget *parent = nullptr);
+    FlowHistoryDelegate(FlowHistory *history, QObject *parent = nullptr);
 
-    void setCurrentJob(const Job &job) { m_currentJob = job; }
-    Job currentJob() const { return m_currentJob; }
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
-    void resizeEvent(QResizeEvent *) override;
-    void paintEvent(QPaintEvent *) override;
 private:
-    HostInfo *m_hostInfo;
-    StatusView *m_statusView;
-    Job m_currentJob;
-    QImage m_backingStore;
-    bool m_isVirgin;
+    FlowHistory *m_history;
 };
 
 class FlowTableView
@@ -62,11 +106,14 @@ public:
 
     virtual QWidget *widget() const override;
 
+    virtual void setMonitor(Monitor *monitor) override;
+
     void update(const Job &job) override;
     void checkNode(unsigned int hostid) override;
     void removeNode(unsigned int hostid) override;
 
     QString id() const override { return QStringLiteral("flow"); }
+    HostInfo::Fields hostFields() const override;
 
     void stop() override {}
     void start() override {}
@@ -74,10 +121,14 @@ public:
     bool isPausable() override { return false; }
     bool isConfigurable() override { return false; }
 
+private slots:
+    void advanceHistory();
+
 private:
-    QScopedPointer<QTableWidget> m_widget;
-    QString hostInfoText(HostInfo *hostInfo, int runningProcesses = 0);
-    HostIdRowMap m_idToRowMap;
+    QScopedPointer<QTableView> m_widget;
+    FlowTableModel *m_model;
+    QSortFilterProxyModel *m_sortedModel;
+    QScopedPointer<FlowHistory> m_history;
     QTimer *m_updateTimer;
 };
 
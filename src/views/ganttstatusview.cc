@@ -21,25 +21,62 @@
 
 #include "ganttstatusview.h"
 
+#include "elidedtextcache.h"
 #include "job.h"
 #include "hostinfo.h"
 #include "utils.h"
 
+#include <QComboBox>
+#include <QCoreApplication>
 #include <QDebug>
-#include <qlabel.h>
-#include <qlayout.h>
+#include <QLabel>
 #include <qpainter.h>
-#include <qpixmap.h>
 #include <qtimer.h>
 #include <qcheckbox.h>
 #include <qpushbutton.h>
 #include <QBoxLayout>
 #include <QList>
-#include <QGridLayout>
 #include <QFrame>
 #include <QResizeEvent>
 #include <QPaintEvent>
 #include <QScrollBar>
+#include <QToolTip>
+#include <QWheelEvent>
+
+#include <algorithm>
+
+#include <limits.h>
+
+namespace {
+
+const int HOST_SPACING = 5;
+const int TIME_SCALE_HEIGHT = 50;
+const int MIN_TICK_DISTANCE = 8;
+/// The resolution of the old tick based chart
+const int DEFAULT_MSEC_PER_PIXEL = 25;
+const int MIN_UPDATE_INTERVAL = 25;
+const int MAX_UPDATE_INTERVAL = 250;
+/// Jobs are kept at least this long, so that zooming out shows a whole build
+const qint64 HISTORY_MSEC = 30 * 60 * 1000;
+const qint64 TRIM_INTERVAL_MSEC = 1000;
+/// The label of the box is complete, it does not need to be rendered again
+const int NO_NEXT_TEXT_WIDTH = INT_MAX;
+/// Hosts without any activity for this long are removed from the chart
+const qint64 AGE_TIMEOUT_MSEC = 30 * 1000;
+
+QString formatDuration(qint64 msec)
+{
+    if (msec == 0) {
+        return QStringLiteral("0");
+    } else if (msec < 1000) {
+        return QCoreApplication::translate("GanttChart", "%1 ms").arg(msec);
+    } else if (msec < 60000 || msec % 60000 != 0) {
+        return QCoreApplication::translate("GanttChart", "%1 s").arg(msec / 1000.0);
+    }
+    return QCoreApplication::translate("GanttChart", "%1 min").arg(msec / 60000);
+}
+
+}
 
 GanttConfigDialog::GanttConfigDialog(QWidget *parent)
     : QDialog(parent)
@@ -53,6 +90,21 @@ GanttConfigDialog::GanttConfigDialog(QWidget *parent)
     connect(mTimeScaleVisibleCheck, SIGNAL(clicked()),
             SIGNAL(configChanged()));
 
+    QBoxLayout *resolutionLayout = new QHBoxLayout();
+    topLayout->addLayout(resolutionLayout);
+
+    QLabel *label = new QLabel(tr("Time per pixel:"), this);
+    resolutionLayout->addWidget(label);
+
+    mResolutionCombo = new QComboBox(this);
+    foreach (int msec, GanttChart::zoomLevels()) {
+        mResolutionCombo->addItem(formatDuration(msec), msec);
+    }
+    label->setBuddy(mResolutionCombo);
+    resolutionLayout->addWidget(mResolutionCombo, 1);
+    connect(mResolutionCombo, SIGNAL(activated(int)),
+            SIGNAL(configChanged()));
+
     auto hline = new QFrame(this);
     hline->setFrameShape(QFrame::HLine);
     topLayout->addWidget(hline);
@@ -76,181 +128,476 @@ bool GanttConfigDialog::isTimeScaleVisible()
     return mTimeScaleVisibleCheck->isChecked();
 }
 
-GanttTimeScaleWidget::GanttTimeScaleWidget(QWidget *parent)
-    : QWidget(parent)
-    , mPixelsPerSecond(40)
+int GanttConfigDialog::msecPerPixel() const
 {
-    QPalette pal = palette();
-    pal.setColor(backgroundRole(), Qt::white);
-    setPalette(pal);
+    return mResolutionCombo->itemData(mResolutionCombo->currentIndex()).toInt();
 }
 
-void GanttTimeScaleWidget::setPixelsPerSecond(int v)
+void GanttConfigDialog::setMsecPerPixel(int msec)
 {
-    mPixelsPerSecond = v;
+    const int index = mResolutionCombo->findData(msec);
+    if (index >= 0) {
+        mResolutionCombo->setCurrentIndex(index);
+    }
 }
 
-void GanttTimeScaleWidget::paintEvent(QPaintEvent *pe)
+GanttSlot::GanttSlot(unsigned int hostid)
+    : m_first(0)
+    , m_count(0)
+    , mNextTextWidth(0)
+    , mFreeIndex(-1)
+    , mHostId(hostid)
+    , mIsFree(true)
 {
-    const QRect r = pe->rect();
+}
 
-    QPainter p(this);
-    const QFontMetrics fm = p.fontMetrics();
+bool GanttSlot::update(const Job &job, qint64 time)
+{
+    if (m_count > 0 && newest().job == job) {
+        if (!job.isDone()) {
+            return false;
+        }
+        append(JobData(IdleJob(), time));
+        mIsFree = true;
+    } else {
+        append(JobData(job, time));
+        mIsFree = (job.state == Job::Idle);
+    }
+
+    mNextTextWidth = 0;
+    return true;
+}
 
-    // Maybe the rectangle overlaps the right half of a number, check whether
-    // that is the case and repaint that number if necessary.
-    if (r.x() % 100 != 0) {
-        const int lastNumberXPos = r.x() - (r.x() % 100);
-        QString lastNumber = QString::number(lastNumberXPos / 100 * 5);
-        if (r.x() % 100 < p.fontMetrics().width(lastNumber)) {
-            p.drawText(lastNumberXPos - r.x() + 2, fm.ascent(), lastNumber);
+void GanttSlot::append(const JobData &data)
+{
+    if (m_count == m_ring.size()) {
+        QVector<JobData> ring(qMax(4, m_ring.size() * 2));
+        for (int i = 0; i < m_count; ++i) {
+            ring[i] = at(i);
         }
+        m_ring.swap(ring);
+        m_first = 0;
     }
+    m_ring[(m_first + m_count) & (m_ring.size() - 1)] = data;
+    ++m_count;
+}
 
-    // Now draw all the bars and numbers, very straightforward.
-    for (int x = 0; x < r.width(); ++x) {
-        const int absX = x + r.x();
-        if (absX % (mPixelsPerSecond * 10) == 0) {
-            p.drawLine(x, -r.y(), x, height() / 2 - r.y());
-            p.drawText(x + 2, fm.ascent() - r.y(),
-                       QString::number(absX /
-                                       mPixelsPerSecond));
-        } else if (absX % (mPixelsPerSecond * 5) == 0) {
-            p.drawLine(x, -r.y(), x, height() / 4 - r.y());
-            p.drawText(x + 2, fm.ascent() - r.y(),
-                       QString::number(absX /
-                                       mPixelsPerSecond));
-        } else if (absX % (mPixelsPerSecond) == 0) {
-            p.drawLine(x, -r.y(), x, height() / 8 - r.y());
+int GanttSlot::indexAt(qint64 time) const
+{
+    // the last job that started at or before time
+    int lo = 0;
+    int hi = m_count;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (at(mid).start <= time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+    return lo - 1;
 }
 
-GanttProgress::GanttProgress(StatusView *statusView, QWidget *parent)
-    : QWidget(parent)
-    , mStatusView(statusView)
-    , mClock(0)
-    , mIsFree(true)
+void GanttSlot::trim(qint64 time)
 {
-    QPalette pal = palette();
-    pal.setColor(backgroundRole(), Qt::white);
-    setPalette(pal);
+    // keep the job that was still running at that time
+    const int index = indexAt(time);
+    if (index > 0) {
+        m_first = (m_first + index) & (m_ring.size() - 1);
+        m_count -= index;
+    }
 }
 
-void GanttProgress::progress()
+GanttChart::GanttChart(GanttStatusView *view)
+    : mView(view)
+    , mContentHeight(0)
+    , mLabelWidth(0)
+    , mLineHeight(fontMetrics().height() + 6)
+    , mFontId(-1)
+    , mHead(0)
+    , mMsecPerPixel(DEFAULT_MSEC_PER_PIXEL)
+    , mColumn(0)
+    , mLastTrim(0)
+    , mSyncingScrollBar(false)
+    , mTimeScaleVisible(false)
+    , mLayoutDirty(true)
 {
-    mClock += 1;
-    adjustGraph();
-    QWidget::update();
+
+    QPalette pal = viewport()->palette();
+    pal.setColor(viewport()->backgroundRole(), Qt::white);
+    viewport()->setPalette(pal);
+    viewport()->setAutoFillBackground(true);
+
+    mTime.start();
 }
 
-void GanttProgress::adjustGraph()
+QVector<int> GanttChart::zoomLevels()
 {
-    // Remove non-visible jobs
-    if (m_jobs.count() >= 2 &&
-        mClock - m_jobs[m_jobs.count() - 2].clock > width()) {
-        m_jobs.removeAt(m_jobs.count() - 1);
+    static const int levels[] = {
+        10, 25, 50, 100, 250, 500,
+        1000, 2000, 5000, 10000, 30000,
+        60000, 120000, 300000
+    };
+    QVector<int> result;
+    for (unsigned int i = 0; i < sizeof(levels) / sizeof(levels[0]); ++i) {
+        result.append(levels[i]);
     }
+    return result;
 }
 
-void GanttProgress::update(const Job &job)
+void GanttChart::setMsecPerPixel(int msec)
 {
-    if (!m_jobs.isEmpty() && m_jobs.first().job == job) {
-        if (job.state == Job::Finished || job.state == Job::Failed) {
-            Job j = IdleJob();
-            m_jobs.prepend(JobData(j, mClock));
-            mIsFree = true;
+    msec = qMax(1, msec);
+    if (mMsecPerPixel == msec) {
+        return;
+    }
+
+    // keep showing the same point in time
+    const int value = int(qint64(horizontalScrollBar()->value()) * mMsecPerPixel / msec);
+    mMsecPerPixel = msec;
+    updateHorizontalRange(now(), value);
+    if (!mLayoutDirty) {
+        redraw();
+    }
+    emit msecPerPixelChanged(mMsecPerPixel);
+}
+
+void GanttChart::zoomIn()
+{
+    const QVector<int> levels = zoomLevels();
+    for (int i = levels.size() - 1; i >= 0; --i) {
+        if (levels.at(i) < mMsecPerPixel) {
+            setMsecPerPixel(levels.at(i));
+            return;
+        }
+    }
+}
+
+void GanttChart::zoomOut()
+{
+    foreach (int level, zoomLevels()) {
+        if (level > mMsecPerPixel) {
+            setMsecPerPixel(level);
+            return;
         }
-    } else {
-        m_jobs.prepend(JobData(job, mClock));
-        mIsFree = (job.state == Job::Idle);
     }
 }
 
-void GanttProgress::drawGraph(QPainter &p)
+void GanttChart::setTimeScaleVisible(bool visible)
 {
-    if (height() == 0) {
+    if (mTimeScaleVisible == visible) {
         return;
     }
+    mTimeScaleVisible = visible;
+    invalidateLayout();
+}
 
-    bool lastBox = false;
-    int xStart = 0;
-    QList<JobData>::ConstIterator it = m_jobs.constBegin();
-    for (; (it != m_jobs.constEnd()) && !lastBox; ++it) {
-        int xEnd = mClock - (*it).clock;
+void GanttChart::invalidateLayout()
+{
+    mLayoutDirty = true;
+    viewport()->update();
+}
 
-        if (xEnd > width()) {
-            xEnd = width();
-            lastBox = true;
-        }
+int GanttChart::headerHeight() const
+{
+    return mTimeScaleVisible ? TIME_SCALE_HEIGHT : 0;
+}
+
+QRect GanttChart::chartRect() const
+{
+    return QRect(mLabelWidth, headerHeight(),
+                 qMax(0, viewport()->width() - mLabelWidth),
+                 qMax(0, viewport()->height() - headerHeight()));
+}
+
+void GanttChart::visibleLines(int *begin, int *end) const
+{
+    const int top = verticalScrollBar()->value();
+    const int bottom = top + mImage.height();
+    auto lessY = [](const Line &line, int y) { return line.y < y; };
+
+    *begin = std::lower_bound(mLines.constBegin(), mLines.constEnd(), top - mLineHeight + 1, lessY) - mLines.constBegin();
+    *end = std::lower_bound(mLines.constBegin(), mLines.constEnd(), bottom, lessY) - mLines.constBegin();
+}
+
+bool GanttChart::isLive() const
+{
+    return horizontalScrollBar()->value() == 0;
+}
 
-        int xWidth = xEnd - xStart;
-        if (xWidth == 0) {
+qint64 GanttChart::viewTime() const
+{
+    return isLive() ? now() : (mColumn + 1) * mMsecPerPixel - 1;
+}
+
+void GanttChart::updateHorizontalRange(qint64 time, int value)
+{
+    const qint64 history = qMin(time, HISTORY_MSEC) / mMsecPerPixel;
+    const int maximum = int(qBound<qint64>(0, history - mImage.width(), INT_MAX));
+
+    // the shown time window does not change, no need to redraw
+    mSyncingScrollBar = true;
+    QScrollBar *bar = horizontalScrollBar();
+    bar->setPageStep(qMax(1, mImage.width()));
+    bar->setSingleStep(qMax(1, mImage.width() / 10));
+    bar->setRange(0, maximum);
+    bar->setValue(value);
+    mSyncingScrollBar = false;
+}
+
+int GanttChart::endColumn(qint64 time) const
+{
+    // a column shows the job that was running at its end
+    const qint64 column = mColumn - time / mMsecPerPixel + 1;
+    return int(qMin<qint64>(column, mImage.width()));
+}
+
+void GanttChart::relayout()
+{
+    mLayoutDirty = false;
+    mLines.clear();
+    mLabels.clear();
+    mFontId = ElidedTextCache::instance()->fontId(viewport()->font());
+
+    QFont font = viewport()->font();
+    font.setBold(true);
+    const QFontMetrics fm(font);
+
+    int y = 0;
+    mLabelWidth = 0;
+    const GanttStatusView::NodeMap &nodes = mView->nodeMap();
+    for (GanttStatusView::NodeMap::ConstIterator it = nodes.constBegin(); it != nodes.constEnd(); ++it) {
+        if ((*it).isEmpty()) {
             continue;
         }
 
-        // Draw the rectangle for the current job
-        QColor color = colorForStatus((*it).job);
-        p.fillRect(xStart, 0, xWidth, height(), color);
-        p.setPen(color.dark());
-        p.drawRect(xStart, 0, xWidth, height());
-
-        if (xWidth > 4 && height() > 4) {
-            int width = xWidth - 4;
-            QString s = (*it).job.fileName;
-            if (!s.isEmpty()) {
-                s = s.mid(s.lastIndexOf(QLatin1Char('/')) + 1, s.length());
-
-                // Optimization - cache the drawn text in a pixmap, and update the cache
-                // only if the pixmap height doesn't match, if the pixmap width is too large,
-                // or if the shortened text with another character added (next_text_width) would fit
-                if (width >= (*it).next_text_width || width < (*it).text_cache.width()
-                    || height() - 4 != (*it).text_cache.height()) {
-                    // If we print the filename, check whether we need to truncate it and
-                    // append "..." at the end.
-                    int text_width = p.fontMetrics().width(s);
-                    if (text_width > width) {
-                        int threeDotsWidth = p.fontMetrics().width(QStringLiteral("..."));
-                        int next_width = 0;
-                        int newLength = 0;
-                        for (;
-                             next_width <= width;
-                             ++newLength) {
-                            text_width = next_width;
-                            next_width = p.fontMetrics().width(s.left(newLength)) +
-                                         threeDotsWidth;
-                        }
-
-                        (*it).next_text_width = next_width;
-                        s  = s.left(newLength > 2 ? newLength - 2 : 0) + QStringLiteral("...");
-                    } else {
-                        (*it).next_text_width = 1000000; // large number (no next width)
-                    }
-                    // Finally draw the text.
-                    if (text_width > 0) {
-                        (*it).text_cache = QPixmap(text_width, height() - 4);
-                        (*it).text_cache.fill(color);
-                        QPainter painter(&(*it).text_cache);
-                        painter.setPen(Utils::textColor(color));
-                        painter.drawText(0, 0, text_width, height() - 4,
-                                         Qt::AlignVCenter | Qt::AlignLeft, s);
-                    }
-                }
-                if (!(*it).text_cache.isNull()) {
-                    p.drawPixmap(xStart + 2, 2, (*it).text_cache);
-                }
+        Label label;
+        label.name = mView->nameForHost(it.key());
+        label.color = mView->hostColor(it.key());
+        label.y = y;
+        label.height = (*it).count() * mLineHeight;
+        mLabels.append(label);
+        mLabelWidth = qMax(mLabelWidth, fm.width(label.name));
+
+        foreach (GanttSlot *slot, *it) {
+            Line line = { slot, y };
+            mLines.append(line);
+            y += mLineHeight;
+        }
+        y += HOST_SPACING;
+    }
+    mContentHeight = y;
+    mLabelWidth += 2 * HOST_SPACING;
+
+    const int chartHeight = chartRect().height();
+    verticalScrollBar()->setPageStep(chartHeight);
+    verticalScrollBar()->setSingleStep(mLineHeight);
+    verticalScrollBar()->setRange(0, qMax(0, mContentHeight - chartHeight));
+
+    redraw();
+}
+
+void GanttChart::redraw()
+{
+    const QRect rect = chartRect();
+    if (mImage.size() != rect.size()) {
+        mImage = (rect.isEmpty() ? QImage() : QImage(rect.size(), QImage::Format_RGB32));
+    }
+    mHead = 0;
+    mColumn = now() / mMsecPerPixel - horizontalScrollBar()->value();
+    viewport()->update();
+    if (mImage.isNull()) {
+        return;
+    }
+
+    mImage.fill(Qt::white);
+    QPainter p(&mImage);
+    p.setFont(viewport()->font());
+
+    const bool live = isLive();
+    const qint64 time = viewTime();
+
+    int begin, end;
+    visibleLines(&begin, &end);
+    for (int i = begin; i < end; ++i) {
+        const Line &line = mLines.at(i);
+        const GanttSlot *slot = line.slot;
+
+        // only the jobs overlapping the time window are visited
+        int xStart = 0;
+        for (int index = slot->indexAt(time); index >= 0 && xStart < mImage.width(); --index) {
+            const GanttSlot::JobData &data = slot->at(index);
+            const int xEnd = endColumn(data.start);
+            if (xEnd > xStart) {
+                paintBox(p, line, data, xStart, xEnd, live && index == slot->count() - 1);
+                xStart = xEnd;
             }
         }
+    }
+}
+
+void GanttChart::advance()
+{
+    const qint64 time = now();
+
+    if (time - mLastTrim >= TRIM_INTERVAL_MSEC) {
+        // keep enough history to zoom out to the coarsest level
+        const qint64 history = qMax<qint64>(HISTORY_MSEC, qint64(viewport()->width()) * mMsecPerPixel);
+        foreach (const Line &line, mLines) {
+            line.slot->trim(time - history);
+        }
+        mLastTrim = time;
+    }
+
+    if (mLayoutDirty) {
+        relayout();
+        return;
+    }
+    if (mImage.isNull()) {
+        return;
+    }
+
+    const int scrolled = horizontalScrollBar()->value();
+    const qint64 columns = time / mMsecPerPixel - scrolled - mColumn;
+    if (scrolled > 0) {
+        // scrolled back, keep showing the same time window
+        updateHorizontalRange(time, int(qMin<qint64>(scrolled + columns, INT_MAX)));
+        return;
+    }
+    updateHorizontalRange(time, 0);
+
+    if (columns >= mImage.width()) {
+        redraw();
+        return;
+    }
+    mColumn += columns;
+
+    // reuse the columns of the oldest pixels for the new ones
+    mHead = int((mHead - columns) % mImage.width());
+    if (mHead < 0) {
+        mHead += mImage.width();
+    }
+
+    QPainter p(&mImage);
+    p.setFont(viewport()->font());
+    if (columns > 0) {
+        p.fillRect(mHead, 0, int(columns), mImage.height(), Qt::white);
+        if (mHead + columns > mImage.width()) {
+            p.fillRect(0, 0, int(mHead + columns - mImage.width()), mImage.height(), Qt::white);
+        }
+    }
+
+    // the previously current column may have changed since it was painted
+    int begin, end;
+    visibleLines(&begin, &end);
+    for (int i = begin; i < end; ++i) {
+        paintRecent(p, mLines.at(i), int(columns) + 1);
+    }
+
+    viewport()->update(chartRect());
+}
+
+void GanttChart::paintRecent(QPainter &p, const Line &line, int xTo)
+{
+    const GanttSlot *slot = line.slot;
+
+    int xStart = 0;
+    for (int index = slot->count() - 1; index >= 0 && xStart < xTo; --index) {
+        const GanttSlot::JobData &data = slot->at(index);
+        const int xEnd = endColumn(data.start);
+        if (xEnd <= xStart) {
+            continue;
+        }
+
+        const bool newest = (index == slot->count() - 1);
+        if (!newest || xEnd - xStart >= slot->nextTextWidth()) {
+            // older boxes only change at their newer end after a transition,
+            // the newest one as long as its label grows
+            paintBox(p, line, data, xStart, xEnd, newest);
+        } else {
+            // the label sticks to the older end, so it is out of reach
+            paintSpan(p, line, colorForStatus(data.job), xStart, qMin(xEnd, xTo), xEnd <= xTo);
+        }
         xStart = xEnd;
     }
 }
 
-QColor GanttProgress::colorForStatus(const Job &job) const
+void GanttChart::paintBox(QPainter &p, const Line &line, const GanttSlot::JobData &data,
+                          int xStart, int xEnd, bool newest)
+{
+    const int imageWidth = mImage.width();
+    const int y = line.y - verticalScrollBar()->value();
+    const int width = xEnd - xStart;
+    const QColor color = colorForStatus(data.job);
+    GanttSlot *slot = (newest ? line.slot : nullptr);
+
+    // a box may wrap around the end of the ring
+    const int x = (mHead + xStart) % imageWidth;
+    fillSpan(p, x, y, width, color, true);
+    drawLabel(p, x, y, width, data, color, slot);
+    if (x + width > imageWidth) {
+        fillSpan(p, x - imageWidth, y, width, color, true);
+        drawLabel(p, x - imageWidth, y, width, data, color, slot);
+    }
+}
+
+void GanttChart::paintSpan(QPainter &p, const Line &line, const QColor &color,
+                           int xStart, int xEnd, bool startEdge)
+{
+    const int imageWidth = mImage.width();
+    const int y = line.y - verticalScrollBar()->value();
+    const int width = xEnd - xStart;
+
+    const int x = (mHead + xStart) % imageWidth;
+    fillSpan(p, x, y, width, color, startEdge);
+    if (x + width > imageWidth) {
+        fillSpan(p, x - imageWidth, y, width, color, startEdge);
+    }
+}
+
+void GanttChart::fillSpan(QPainter &p, int x, int y, int width, const QColor &color, bool startEdge)
+{
+    // the newer end of a box stays open, it may still grow
+    p.fillRect(x, y, width, mLineHeight, color);
+    p.setPen(color.dark());
+    p.drawLine(x, y, x + width - 1, y);
+    p.drawLine(x, y + mLineHeight - 1, x + width - 1, y + mLineHeight - 1);
+    if (startEdge) {
+        p.drawLine(x + width - 1, y, x + width - 1, y + mLineHeight - 1);
+    }
+}
+
+void GanttChart::drawLabel(QPainter &p, int x, int y, int width, const GanttSlot::JobData &data,
+                           const QColor &color, GanttSlot *slot)
+{
+    if (width <= 4 || mLineHeight <= 4) {
+        if (slot) {
+            slot->setNextTextWidth(5);
+        }
+        return;
+    }
+
+    int nextWidth = NO_NEXT_TEXT_WIDTH;
+    const QString s = ElidedTextCache::instance()->elidedFileName(data.job.fileId, mFontId,
+                                                                  width - 4, &nextWidth);
+    if (!s.isEmpty()) {
+        // the label sticks to the start of the job, so that it moves along
+        // with the pixels that are reused later on
+        p.setPen(Utils::textColor(color));
+        p.drawText(x + 2, y + 2, width - 4, mLineHeight - 4,
+                   Qt::AlignVCenter | Qt::AlignRight, s);
+    }
+    if (slot) {
+        slot->setNextTextWidth(nextWidth == NO_NEXT_TEXT_WIDTH ? nextWidth : nextWidth + 4);
+    }
+}
+
+QColor GanttChart::colorForStatus(const Job &job) const
 {
     if (job.state == Job::Idle) {
         return Qt::gray;
     } else {
-        QColor c = mStatusView->hostColor(job.client);
+        QColor c = mView->hostColor(job.client);
         if (job.state == Job::LocalOnly) {
             return c.light();
         } else {
@@ -259,60 +606,207 @@ QColor GanttProgress::colorForStatus(const Job &job) const
     }
 }
 
-void GanttProgress::paintEvent(QPaintEvent *)
+void GanttChart::paintTimeScale(QPainter &p)
+{
+    const int height = headerHeight();
+    const QFontMetrics fm = p.fontMetrics();
+
+    // the smallest step that keeps the ticks apart, labels on every fifth
+    static const int steps[] = {
+        100, 250, 500, 1000, 2000, 5000, 10000, 15000, 30000,
+        60000, 120000, 300000, 600000, 900000, 1800000, 3600000
+    };
+    qint64 step = 0;
+    for (unsigned int i = 0; i < sizeof(steps) / sizeof(steps[0]); ++i) {
+        step = steps[i];
+        if (step / mMsecPerPixel >= MIN_TICK_DISTANCE) {
+            break;
+        }
+    }
+
+    p.setPen(Qt::black);
+    for (qint64 tick = 0; ; ++tick) {
+        const int x = mLabelWidth + int(tick * step / mMsecPerPixel);
+        if (x >= viewport()->width()) {
+            break;
+        }
+        if (tick % 10 == 0) {
+            p.drawLine(x, 0, x, height / 2);
+            p.drawText(x + 2, fm.ascent(), formatDuration(tick * step));
+        } else if (tick % 5 == 0) {
+            p.drawLine(x, 0, x, height / 4);
+            p.drawText(x + 2, fm.ascent(), formatDuration(tick * step));
+        } else {
+            p.drawLine(x, 0, x, height / 8);
+        }
+    }
+}
+
+void GanttChart::paintLabels(QPainter &p, const QRect &rect)
+{
+    p.save();
+    p.setClipRect(0, headerHeight(), mLabelWidth, viewport()->height() - headerHeight());
+
+    QFont font = p.font();
+    font.setBold(true);
+    p.setFont(font);
+
+    const int offset = headerHeight() - verticalScrollBar()->value();
+    foreach (const Label &label, mLabels) {
+        const QRect labelRect(HOST_SPACING, offset + label.y, mLabelWidth - HOST_SPACING, label.height);
+        if (labelRect.intersects(rect)) {
+            p.setPen(label.color);
+            p.drawText(labelRect, Qt::AlignLeft | Qt::AlignVCenter, label.name);
+        }
+    }
+    p.restore();
+}
+
+void GanttChart::paintEvent(QPaintEvent *e)
+{
+    if (mLayoutDirty) {
+        relayout();
+    }
+
+    QPainter p(viewport());
+    if (e->rect().top() < headerHeight()) {
+        paintTimeScale(p);
+    }
+    if (e->rect().left() < mLabelWidth) {
+        paintLabels(p, e->rect());
+    }
+
+    const QRect rect = chartRect();
+    if (mImage.isNull() || !e->rect().intersects(rect)) {
+        return;
+    }
+
+    // the current time is in column mHead, older columns follow to the right
+    const int first = mImage.width() - mHead;
+    p.drawImage(rect.topLeft(), mImage, QRect(mHead, 0, first, mImage.height()));
+    if (mHead > 0) {
+        p.drawImage(rect.topLeft() + QPoint(first, 0), mImage, QRect(0, 0, mHead, mImage.height()));
+    }
+}
+
+void GanttChart::resizeEvent(QResizeEvent *e)
+{
+    QAbstractScrollArea::resizeEvent(e);
+    invalidateLayout();
+}
+
+void GanttChart::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+
+    if (!mLayoutDirty && !mSyncingScrollBar) {
+        redraw();
+    }
+}
+
+bool GanttChart::viewportEvent(QEvent *e)
+{
+    if (e->type() != QEvent::ToolTip) {
+        return QAbstractScrollArea::viewportEvent(e);
+    }
+
+    QHelpEvent *helpEvent = static_cast<QHelpEvent *>(e);
+    const QString text = toolTipAt(helpEvent->pos());
+    if (text.isEmpty()) {
+        QToolTip::hideText();
+        e->ignore();
+    } else {
+        QToolTip::showText(helpEvent->globalPos(), text, viewport());
+    }
+    return true;
+}
+
+QString GanttChart::toolTipAt(const QPoint &pos) const
 {
-    QPainter p(this);
-    p.setBackgroundMode(Qt::OpaqueMode);
-    p.setBackground(palette().background());
-    drawGraph(p);
+    const QRect rect = chartRect();
+    if (!rect.contains(pos)) {
+        return QString();
+    }
+
+    const int y = pos.y() - rect.top() + verticalScrollBar()->value();
+    QVector<Line>::ConstIterator line = std::upper_bound(mLines.constBegin(), mLines.constEnd(), y,
+                                                         [](int value, const Line &other) { return value < other.y; });
+    if (line == mLines.constBegin()) {
+        return QString();
+    }
+    --line;
+    if (y >= (*line).y + mLineHeight) {
+        return QString();
+    }
+
+    // a column shows the job that was running at its end
+    const int x = pos.x() - rect.left();
+    const qint64 time = (x == 0 && isLive()) ? now() : (mColumn - x + 1) * mMsecPerPixel - 1;
+    const GanttSlot *slot = (*line).slot;
+    const int index = slot->indexAt(time);
+    if (index < 0) {
+        return QString();
+    }
+
+    const Job &job = slot->at(index).job;
+    const qint64 duration = slot->endOf(index, now()) - slot->at(index).start;
+    if (job.state == Job::Idle) {
+        return tr("Idle for %1").arg(formatDuration(duration));
+    }
+    return QStringLiteral("<b>%1</b><br/>%2<br/>%3")
+           .arg(job.fileName().toHtmlEscaped(),
+                tr("Client: %1").arg(mView->nameForHost(job.client).toHtmlEscaped()),
+                tr("%1 for %2").arg(job.stateAsString(), formatDuration(duration)));
 }
 
-void GanttProgress::resizeEvent(QResizeEvent *)
+void GanttChart::wheelEvent(QWheelEvent *e)
 {
-    adjustGraph();
+    if (!(e->modifiers() & Qt::ControlModifier)) {
+        QAbstractScrollArea::wheelEvent(e);
+        return;
+    }
+
+    if (e->angleDelta().y() > 0) {
+        zoomIn();
+    } else if (e->angleDelta().y() < 0) {
+        zoomOut();
+    }
+    e->accept();
 }
 
 GanttStatusView::GanttStatusView(QObject *parent)
     : StatusView(parent)
-    , m_widget(new QScrollArea)
-    , mTopWidget(new QWidget)
+    , m_widget(new GanttChart(this))
+    , mRunning(false)
+    , mUpdateInterval(MIN_UPDATE_INTERVAL)
 {
     mConfigDialog = new GanttConfigDialog(m_widget.data());
     connect(mConfigDialog, SIGNAL(configChanged()),
             SLOT(slotConfigChanged()));
 
-    m_widget->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_widget->setWidget(mTopWidget);
-    m_widget->setWidgetResizable(true);
-
-    QPalette palette = mTopWidget->palette();
-    palette.setColor(mTopWidget->backgroundRole(), Qt::white);
-    mTopWidget->setPalette(palette);
-
-    m_topLayout = new QGridLayout(mTopWidget);
-    m_topLayout->setSpacing(5);
-    m_topLayout->setMargin(4);
-    m_topLayout->setColumnStretch(1, 10);
-
-    mTimeScale = new GanttTimeScaleWidget(mTopWidget);
-    mTimeScale->setFixedHeight(50);
-    m_topLayout->addWidget(mTimeScale, 0, 1);
-
     m_progressTimer = new QTimer(this);
     connect(m_progressTimer, SIGNAL(timeout()), SLOT(updateGraphs()));
     m_ageTimer = new QTimer(this);
+    m_ageTimer->setSingleShot(true);
     connect(m_ageTimer, SIGNAL(timeout()), SLOT(checkAge()));
 
-    mUpdateInterval = 25;
-    mTimeScale->setPixelsPerSecond(1000 / mUpdateInterval);
-
-    mMinimumProgressHeight = QFontMetrics(m_widget->font()).height() + 6;
+    connect(m_widget.data(), SIGNAL(msecPerPixelChanged(int)), SLOT(updateResolution(int)));
+    mConfigDialog->setMsecPerPixel(m_widget->msecPerPixel());
+    updateResolution(m_widget->msecPerPixel());
 
     slotConfigChanged();
 
     start();
 }
 
+GanttStatusView::~GanttStatusView()
+{
+    foreach (const SlotList &slotList, mNodeMap) {
+        qDeleteAll(slotList);
+    }
+}
+
 void GanttStatusView::update(const Job &job)
 {
     if (!mRunning) {
@@ -323,14 +817,14 @@ void GanttStatusView::update(const Job &job)
         return;
     }
 
-    QMap<unsigned int, GanttProgress *>::Iterator it;
-
-    it = mJobMap.find(job.id);
+    JobMap::Iterator it = mJobMap.find(job.id);
 
     if (it != mJobMap.end()) {
-        it.value()->update(job);
+        GanttSlot *slot = it.value();
+        slot->update(job, m_widget->now());
         if (job.state == Job::Finished || job.state == Job::Failed) {
             mJobMap.erase(it);
+            updateFreeList(slot);
         }
         return;
     }
@@ -339,8 +833,6 @@ void GanttStatusView::update(const Job &job)
         return;
     }
 
-    GanttProgress *slot = nullptr;
-
     unsigned int processor;
     if (job.state == Job::LocalOnly) {
         processor = job.client;
@@ -352,28 +844,15 @@ void GanttStatusView::update(const Job &job)
         return;
     }
 
-    NodeMap::ConstIterator it2 = mNodeMap.constFind(processor);
-    if (it2 == mNodeMap.constEnd()) {
+    GanttSlot *slot = takeFreeSlot(processor);
+    if (!slot) {
         slot = registerNode(processor);
-    } else {
-        SlotList slotList = it2.value();
-        SlotList::ConstIterator it3;
-        for (it3 = slotList.constBegin(); it3 != slotList.constEnd(); ++it3) {
-            if ((*it3)->isFree()) {
-                slot = *it3;
-                break;
-            }
-        }
-
-        if (it3 == slotList.constEnd()) {
-            slot = registerNode(processor);
-        }
     }
 
-    Q_ASSERT(slot);
     mJobMap.insert(job.id, slot);
-    slot->update(job);
-    mAgeMap[processor] = 0;
+    slot->update(job, m_widget->now());
+    updateFreeList(slot);
+    touchNode(processor);
 }
 
 QWidget *GanttStatusView::widget() const
@@ -388,16 +867,20 @@ void GanttStatusView::checkNode(unsigned int hostid)
     }
 
     if (mNodeMap.find(hostid) == mNodeMap.end()) {
-        registerNode(hostid)->update(IdleJob());
+        GanttSlot *slot = registerNode(hostid);
+        slot->update(IdleJob(), m_widget->now());
+        updateFreeList(slot);
     }
     unsigned int max_kids = hostInfoManager()->maxJobs(hostid);
     for (unsigned int i = mNodeMap[hostid].count();
          i < max_kids;
          ++i) {
-        registerNode(hostid)->update(IdleJob());
+        GanttSlot *slot = registerNode(hostid);
+        slot->update(IdleJob(), m_widget->now());
+        updateFreeList(slot);
     }
 
-    mAgeMap[hostid] = 0;
+    touchNode(hostid);
 
     SlotList slotList = mNodeMap[hostid];   // make a copy
     int to_remove = slotList.count() - max_kids;
@@ -405,12 +888,12 @@ void GanttStatusView::checkNode(unsigned int hostid)
         return;
     }
 
-    QListIterator<GanttProgress *> it2(slotList);
+    QListIterator<GanttSlot *> it2(slotList);
     it2.toBack();
     while (it2.hasPrevious()) {
-        GanttProgress *progress = it2.previous();
-        if (progress->isFree() && progress->fullyIdle()) {
-            removeSlot(hostid, progress);
+        GanttSlot *slot = it2.previous();
+        if (slot->isFree() && slot->fullyIdle()) {
+            removeSlot(hostid, slot);
             if (--to_remove == 0) {
                 return;
             }
@@ -418,114 +901,123 @@ void GanttStatusView::checkNode(unsigned int hostid)
     }
 }
 
-GanttProgress *GanttStatusView::registerNode(unsigned int hostid)
+GanttSlot *GanttStatusView::registerNode(unsigned int hostid)
 {
-//    qDebug() << "GanttStatusView::registerNode(): " << ip << endl;
+    auto slot = new GanttSlot(hostid);
+    mNodeMap[hostid].append(slot);
+    touchNode(hostid);
+    m_widget->invalidateLayout();
 
-    static int lastRow = 0;
+    return slot;
+}
 
-    QColor color = hostColor(hostid);
+void GanttStatusView::removeSlot(unsigned int hostid, GanttSlot *slot)
+{
+    NodeMap::Iterator it = mNodeMap.find(hostid);
+    if (it == mNodeMap.end()) {
+        return;
+    }
 
-    QVBoxLayout *nodeLayout;
+    (*it).removeOne(slot);
+    if (!slot->isFree()) {
+        mJobMap.remove(slot->jobId());
+    } else if (slot->freeIndex() >= 0) {
+        removeFromFreeList(slot);
+    }
 
-    NodeLayoutMap::ConstIterator it = mNodeLayouts.constFind(hostid);
-    if (it == mNodeLayouts.constEnd()) {
-        ++lastRow;
+    m_widget->invalidateLayout();
+    delete slot;
+}
 
-        nodeLayout = new QVBoxLayout();
-        nodeLayout->setObjectName(QStringLiteral("%1_layout").arg(hostid));
-        m_topLayout->addLayout(nodeLayout, lastRow, 1);
-        mNodeLayouts.insert(hostid, nodeLayout);
-        mNodeRows.insert(hostid, lastRow);
-    } else {
-        nodeLayout = it.value();
+void GanttStatusView::unregisterNode(unsigned int hostid)
+{
+    NodeMap::ConstIterator it = mNodeMap.constFind(hostid);
+    if (it == mNodeMap.constEnd()) {
+        return;
     }
+    while (!mNodeMap[hostid].isEmpty())
+        removeSlot(hostid, mNodeMap[hostid].first());
+    mNodeMap.remove(hostid);
+    mFreeSlots.remove(hostid);
 
-    NodeRowMap::ConstIterator rowIt = mNodeRows.constFind(hostid);
-    if (rowIt == mNodeRows.constEnd()) {
-    } else {
-        int row = *rowIt;
-        NodeLabelMap::ConstIterator labelIt = mNodeLabels.constFind(hostid);
-        if (labelIt == mNodeLabels.constEnd()) {
-            QString name = nameForHost(hostid);
-            auto l = new QLabel(name, mTopWidget);
-            QPalette palette = l->palette();
-            palette.setColor(l->foregroundRole(), color);
-            palette.setColor(l->backgroundRole(), Qt::white);
-            l->setPalette(palette);
-            m_topLayout->addWidget(l, row, 0);
-
-            QFont f = l->font();
-            f.setBold(true);
-            l->setFont(f);
-
-            l->show();
-            mNodeLabels.insert(hostid, l);
-        }
+    QHash<unsigned int, Age>::Iterator ageIt = mAges.find(hostid);
+    if (ageIt != mAges.end()) {
+        mAgeQueue.remove((*ageIt).deadline, hostid);
+        mAges.erase(ageIt);
     }
+}
 
-    auto w = new GanttProgress(this, mTopWidget);
-    w->setMinimumHeight(mMinimumProgressHeight);
-    nodeLayout->addWidget(w);
+void GanttStatusView::updateFreeList(GanttSlot *slot)
+{
+    if (slot->isFree() == (slot->freeIndex() >= 0)) {
+        return;
+    }
 
-    mNodeMap[hostid].append(w);
-    mAgeMap[hostid] = 0;
+    if (slot->isFree()) {
+        QVector<GanttSlot *> &freeSlots = mFreeSlots[slot->hostId()];
+        slot->setFreeIndex(freeSlots.size());
+        freeSlots.append(slot);
+    } else {
+        removeFromFreeList(slot);
+    }
+}
 
-    m_topLayout->setRowStretch(mNodeRows[hostid], mNodeMap[hostid].size());
+void GanttStatusView::removeFromFreeList(GanttSlot *slot)
+{
+    // swap with the last one, the order of free slots does not matter
+    QVector<GanttSlot *> &freeSlots = mFreeSlots[slot->hostId()];
+    GanttSlot *last = freeSlots.last();
+    freeSlots[slot->freeIndex()] = last;
+    last->setFreeIndex(slot->freeIndex());
+    freeSlots.removeLast();
+    slot->setFreeIndex(-1);
+}
 
-    w->show();
+GanttSlot *GanttStatusView::takeFreeSlot(unsigned int hostid)
+{
+    FreeMap::Iterator it = mFreeSlots.find(hostid);
+    if (it == mFreeSlots.end() || (*it).isEmpty()) {
+        return nullptr;
+    }
 
-    return w;
+    GanttSlot *slot = (*it).last();
+    (*it).removeLast();
+    slot->setFreeIndex(-1);
+    return slot;
 }
 
-void GanttStatusView::removeSlot(unsigned int hostid, GanttProgress *slot)
+void GanttStatusView::touchNode(unsigned int hostid)
 {
-    NodeLayoutMap::ConstIterator it = mNodeLayouts.constFind(hostid);
-    if (it == mNodeLayouts.constEnd()) {
+    const qint64 now = m_widget->now();
+    QHash<unsigned int, Age>::Iterator it = mAges.find(hostid);
+    if (it != mAges.end()) {
+        // the queue entry is moved lazily when it comes due
+        (*it).lastActivity = now;
         return;
     }
 
-    mNodeMap[hostid].removeAll(slot);
-    JobMap newJobMap;
-    for (QMap<unsigned int, GanttProgress *>::Iterator it = mJobMap.begin();
-         it != mJobMap.end();  // QMap::remove doesn't return an iterator like
-         ++it) {               // e.g. in QValueList, and I'm not sure if 'it'
-        if ((*it) != slot) {   // or '++it' would be still valid, so let's copy
-            newJobMap[it.key()] = *it;   // still valid items to a new map
-        }
+    const Age age = { now, now + AGE_TIMEOUT_MSEC };
+    mAges.insert(hostid, age);
+    mAgeQueue.insert(age.deadline, hostid);
+    if (mRunning && !m_ageTimer->isActive()) {
+        scheduleAgeCheck();
     }
-
-    mJobMap = newJobMap;
-
-    m_topLayout->setRowStretch(mNodeRows[hostid], mNodeMap[hostid].size());
-    delete slot;
 }
 
-void GanttStatusView::unregisterNode(unsigned int hostid)
+void GanttStatusView::scheduleAgeCheck()
 {
-    NodeLayoutMap::ConstIterator it = mNodeLayouts.constFind(hostid);
-    if (it == mNodeLayouts.constEnd()) {
+    if (mAgeQueue.isEmpty()) {
+        m_ageTimer->stop();
         return;
     }
-    while (!mNodeMap[hostid].isEmpty())
-        removeSlot(hostid, mNodeMap[hostid].first());
-    NodeLabelMap::Iterator labelIt = mNodeLabels.find(hostid);
-    if (labelIt != mNodeLabels.end()) {
-        delete *labelIt;
-        mNodeLabels.erase(labelIt);
-    }
-    mAgeMap[hostid] = -1;
+
+    const qint64 delay = mAgeQueue.constBegin().key() - m_widget->now();
+    m_ageTimer->start(int(qBound<qint64>(0, delay, AGE_TIMEOUT_MSEC)));
 }
 
 void GanttStatusView::updateGraphs()
 {
-    NodeMap::ConstIterator it;
-    for (it = mNodeMap.constBegin(); it != mNodeMap.constEnd(); ++it) {
-        SlotList::ConstIterator it2;
-        for (it2 = (*it).constBegin(); it2 != (*it).constEnd(); ++it2) {
-            (*it2)->progress();
-        }
-    }
+    m_widget->advance();
 }
 
 void GanttStatusView::stop()
@@ -539,29 +1031,33 @@ void GanttStatusView::start()
 {
     mRunning = true;
     m_progressTimer->start(mUpdateInterval);
-    m_ageTimer->start(10000);
+
+    // the hosts could not report anything while the view was paused
+    const qint64 now = m_widget->now();
+    for (QHash<unsigned int, Age>::Iterator it = mAges.begin(); it != mAges.end(); ++it) {
+        (*it).lastActivity = qMax((*it).lastActivity, now);
+    }
+    scheduleAgeCheck();
 }
 
 void GanttStatusView::checkAge()
 {
-    QList<unsigned int> to_unregister;
-    for (AgeMap::Iterator it = mAgeMap.begin();
-         it != mAgeMap.end();
-         ++it) {
-        if (*it > 1) {
-            to_unregister.append(it.key());
-        } else if (*it < 0) {
-            ; // unregistered ones
+    const qint64 now = m_widget->now();
+    while (!mAgeQueue.isEmpty() && mAgeQueue.constBegin().key() <= now) {
+        const unsigned int hostid = mAgeQueue.constBegin().value();
+        mAgeQueue.erase(mAgeQueue.begin());
+
+        Age &age = mAges[hostid];
+        if (age.lastActivity + AGE_TIMEOUT_MSEC <= now) {
+            mAges.remove(hostid);
+            unregisterNode(hostid);
         } else {
-            ++(*it);
+            age.deadline = age.lastActivity + AGE_TIMEOUT_MSEC;
+            mAgeQueue.insert(age.deadline, hostid);
         }
     }
 
-    for (QList<unsigned int>::ConstIterator it = to_unregister.constBegin();
-         it != to_unregister.constEnd();
-         ++it) {
-        unregisterNode(*it);
-    }
+    scheduleAgeCheck();
 }
 
 void GanttStatusView::configureView()
@@ -572,9 +1068,17 @@ void GanttStatusView::configureView()
 
 void GanttStatusView::slotConfigChanged()
 {
-    if (mConfigDialog->isTimeScaleVisible()) {
-        mTimeScale->show();
-    } else {
-        mTimeScale->hide();
+    m_widget->setTimeScaleVisible(mConfigDialog->isTimeScaleVisible());
+    m_widget->setMsecPerPixel(mConfigDialog->msecPerPixel());
+}
+
+void GanttStatusView::updateResolution(int msecPerPixel)
+{
+    mConfigDialog->setMsecPerPixel(msecPerPixel);
+
+    // there is nothing new to show more often than once per column
+    mUpdateInterval = qBound(MIN_UPDATE_INTERVAL, msecPerPixel, MAX_UPDATE_INTERVAL);
+    if (mRunning) {
+        m_progressTimer->start(mUpdateInterval);
     }
 }
@@ -26,14 +26,17 @@
 
 #include <qdialog.h>
 #include <qmap.h>
-#include <qpixmap.h>
-#include <QScrollArea>
+#include <QAbstractScrollArea>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
 #include <qlist.h>
 
 class QCheckBox;
-class QGridLayout;
+class QComboBox;
 class QTimer;
-class QVBoxLayout;
+
+class GanttStatusView;
 
 class GanttConfigDialog
     : public QDialog
@@ -44,79 +47,196 @@ public:
 
     bool isTimeScaleVisible();
 
+    /// Time covered by one pixel of the chart
+    int msecPerPixel() const;
+    void setMsecPerPixel(int msec);
+
 signals:
     void configChanged();
 
 private:
     QCheckBox *mTimeScaleVisibleCheck;
+    QComboBox *mResolutionCombo;
 };
 
-class GanttTimeScaleWidget
-    : public QWidget
+/**
+ * One job slot of a host, drawn as one line of the chart
+ *
+ * Each job lasts from its start time until the start of the next one, so
+ * the jobs are kept in a ring ordered by start time, which doubles as an
+ * interval index: the job running at a given time, and the cut for trimming
+ * by age, are found by binary search.
+ */
+class GanttSlot
 {
-    Q_OBJECT
 public:
-    GanttTimeScaleWidget(QWidget *parent);
+    struct JobData
+    {
+        JobData(Job j = Job(), qint64 s = 0)
+            : job(std::move(j))
+            , start(s) {}
+
+        Job job;
+        qint64 start;   ///< msec on the chart's clock
+    };
 
-    void setPixelsPerSecond(int);
+    explicit GanttSlot(unsigned int hostid);
 
-protected:
-    virtual void paintEvent(QPaintEvent *e) override;
+    unsigned int hostId() const { return mHostId; }
+
+    bool isFree() const { return mIsFree; }
+    bool fullyIdle() const { return m_count == 1 && isFree(); }
+    /// Id of the job occupying the slot, 0 if it is free
+    unsigned int jobId() const { return mIsFree ? 0 : newest().job.id; }
+
+    /// @return true if a new box was started
+    bool update(const Job &job, qint64 time);
+    /// Forget the jobs that ended before @p time
+    void trim(qint64 time);
+
+    bool isEmpty() const { return m_count == 0; }
+    int count() const { return m_count; }
+    /// @p i is 0 for the oldest job
+    const JobData &at(int i) const { return m_ring.at((m_first + i) & (m_ring.size() - 1)); }
+    const JobData &newest() const { return at(m_count - 1); }
+    /// Index of the job running at @p time, -1 if that is before the oldest job
+    int indexAt(qint64 time) const;
+    /// End of job @p i, which is @p now for the newest one
+    qint64 endOf(int i, qint64 now) const { return i + 1 < m_count ? at(i + 1).start : now; }
+
+    /// Width of the newest box at which its label has to be rendered again
+    int nextTextWidth() const { return mNextTextWidth; }
+    void setNextTextWidth(int width) { mNextTextWidth = width; }
+
+    /// Position in the free list of the host, -1 if it is not in there
+    int freeIndex() const { return mFreeIndex; }
+    void setFreeIndex(int index) { mFreeIndex = index; }
 
 private:
-    int mPixelsPerSecond;
+    void append(const JobData &data);
+
+    QVector<JobData> m_ring;    ///< the size is a power of two
+    int m_first;
+    int m_count;
+    int mNextTextWidth;
+    int mFreeIndex;
+    unsigned int mHostId;
+    bool mIsFree;
 };
 
-class GanttProgress
-    : public QWidget
+/**
+ * Renders the slots of all hosts into a single viewport
+ *
+ * Jobs are stored with timestamps, the zoom level only decides how many
+ * milliseconds one column covers. The chart area is kept in a ring image that
+ * only covers the visible lines. When time advances the origin of the ring
+ * moves by the number of elapsed columns, so only the new columns and the
+ * boxes whose label is still growing are painted.
+ *
+ * Scrolling horizontally goes back in time; while scrolled back the shown
+ * time window stays put.
+ */
+class GanttChart
+    : public QAbstractScrollArea
 {
     Q_OBJECT
 public:
-    GanttProgress(StatusView *statusView,
-                  QWidget *parent);
+    explicit GanttChart(GanttStatusView *view);
 
-    bool isFree() const { return mIsFree; }
-    bool fullyIdle() const { return m_jobs.count() == 1 && isFree(); }
+    /// Current time in msec, the reference for all job timestamps
+    qint64 now() const { return mTime.elapsed(); }
 
-public slots:
-    void progress();
-    void update(const Job &job);
+    int msecPerPixel() const { return mMsecPerPixel; }
+    void setMsecPerPixel(int msec);
+    void zoomIn();
+    void zoomOut();
+
+    void setTimeScaleVisible(bool visible);
+
+    /// Hosts or slots were added or removed
+    void invalidateLayout();
+    /// Scroll the chart to the current time
+    void advance();
+
+    /// Zoom levels in msec per pixel, from the finest to the coarsest
+    static QVector<int> zoomLevels();
+
+signals:
+    void msecPerPixelChanged(int msec);
 
 protected:
     virtual void paintEvent(QPaintEvent *e) override;
     virtual void resizeEvent(QResizeEvent *e) override;
+    virtual void scrollContentsBy(int dx, int dy) override;
+    virtual void wheelEvent(QWheelEvent *e) override;
+    virtual bool viewportEvent(QEvent *e) override;
 
 private:
-    void adjustGraph();
-    void drawGraph(QPainter &p);
-    QColor colorForStatus(const Job &job) const;
-
-    struct JobData
+    struct Line
     {
-        JobData(Job j, int c)
-            : job(std::move(j))
-            , clock(c)
-            , next_text_width(0) {}
-        JobData() {} // stupid QValueList
-
-        bool operator==(const JobData &d)
-        {
-            return job == d.job && clock == d.clock;
-        }
-
-        Job job;
-        int clock;
-        mutable int next_text_width;
-        mutable QPixmap text_cache;
+        GanttSlot *slot;
+        int y;          ///< content coordinates, 0 is the first line
     };
 
-    StatusView *mStatusView;
-
-    QList<JobData> m_jobs;
+    struct Label
+    {
+        QString name;
+        QColor color;
+        int y;
+        int height;
+    };
 
-    int mClock;
+    void relayout();
+    /// Rasterize all visible lines from scratch
+    void redraw();
+    /// Follow the current time rather than showing the past
+    bool isLive() const;
+    /// Time shown at the newer end of the chart
+    qint64 viewTime() const;
+    void updateHorizontalRange(qint64 time, int value);
+    QString toolTipAt(const QPoint &pos) const;
+
+    /// Column of the older end of a box that started at @p time
+    int endColumn(qint64 time) const;
+    /// Paint the columns [0, @p xTo) of @p line
+    void paintRecent(QPainter &p, const Line &line, int xTo);
+    void paintBox(QPainter &p, const Line &line, const GanttSlot::JobData &data,
+                  int xStart, int xEnd, bool newest);
+    void paintSpan(QPainter &p, const Line &line, const QColor &color,
+                   int xStart, int xEnd, bool startEdge);
+    void fillSpan(QPainter &p, int x, int y, int width, const QColor &color, bool startEdge);
+    void drawLabel(QPainter &p, int x, int y, int width, const GanttSlot::JobData &data,
+                   const QColor &color, GanttSlot *slot);
+    void paintTimeScale(QPainter &p);
+    void paintLabels(QPainter &p, const QRect &rect);
 
-    bool mIsFree;
+    QColor colorForStatus(const Job &job) const;
+    int headerHeight() const;
+    /// The area covered by mImage, in viewport coordinates
+    QRect chartRect() const;
+    /// Lines intersecting the image, as [begin, end) indexes into mLines
+    void visibleLines(int *begin, int *end) const;
+
+    GanttStatusView *mView;
+
+    QVector<Line> mLines;
+    QVector<Label> mLabels;
+    int mContentHeight;
+    int mLabelWidth;
+    int mLineHeight;
+    int mFontId;        ///< of the labels in ElidedTextCache
+
+    QImage mImage;
+    int mHead;          ///< column of mImage showing the current time
+
+    QElapsedTimer mTime;
+    int mMsecPerPixel;
+    qint64 mColumn;     ///< column shown at the newer end, in mMsecPerPixel units
+    qint64 mLastTrim;
+    bool mSyncingScrollBar;
+
+    bool mTimeScaleVisible;
+    bool mLayoutDirty;
 };
 
 class GanttStatusView
@@ -124,8 +244,11 @@ class GanttStatusView
 {
     Q_OBJECT
 public:
+    using SlotList = QList<GanttSlot *>;
+    typedef QMap<unsigned int, SlotList> NodeMap;
+
     GanttStatusView(QObject *parent = nullptr);
-    virtual ~GanttStatusView() {}
+    virtual ~GanttStatusView();
 
     QString id() const override { return QStringLiteral("gantt"); }
 
@@ -140,6 +263,8 @@ public:
 
     virtual QWidget *widget() const override;
 
+    const NodeMap &nodeMap() const { return mNodeMap; }
+
 public slots:
     virtual void update(const Job &job) override;
 
@@ -147,41 +272,46 @@ private slots:
     void slotConfigChanged();
     void updateGraphs();
     void checkAge();
+    void updateResolution(int msecPerPixel);
 
 private:
-    GanttProgress *registerNode(unsigned int hostid);
-    void removeSlot(unsigned int hostid, GanttProgress *slot);
+    GanttSlot *registerNode(unsigned int hostid);
+    void removeSlot(unsigned int hostid, GanttSlot *slot);
     void unregisterNode(unsigned int hostid);
 
-    GanttConfigDialog *mConfigDialog;
+    /// Keep the free list of the host of @p slot in sync with its state
+    void updateFreeList(GanttSlot *slot);
+    void removeFromFreeList(GanttSlot *slot);
+    GanttSlot *takeFreeSlot(unsigned int hostid);
 
-    QScopedPointer<QScrollArea> m_widget;
-    QWidget *mTopWidget;
-    QGridLayout *m_topLayout;
+    /// Postpone aging out @p hostid
+    void touchNode(unsigned int hostid);
+    void scheduleAgeCheck();
 
-    GanttTimeScaleWidget *mTimeScale;
+    GanttConfigDialog *mConfigDialog;
+
+    QScopedPointer<GanttChart> m_widget;
 
-    using SlotList = QList<GanttProgress *>;
-    typedef QMap<unsigned int, SlotList> NodeMap;
     NodeMap mNodeMap;
-    typedef QMap<unsigned int, int> AgeMap;
-    AgeMap mAgeMap;
-    typedef QMap<unsigned int, GanttProgress *> JobMap;
+    typedef QHash<unsigned int, QVector<GanttSlot *> > FreeMap;
+    FreeMap mFreeSlots;
+    typedef QHash<unsigned int, GanttSlot *> JobMap;
     JobMap mJobMap;
-    typedef QMap<unsigned int, QVBoxLayout *> NodeLayoutMap;
-    NodeLayoutMap mNodeLayouts;
-    typedef QMap<unsigned int, int> NodeRowMap;
-    NodeRowMap mNodeRows;
-    typedef QMap<unsigned int, QWidget *> NodeLabelMap;
-    NodeLabelMap mNodeLabels;
+
+    struct Age
+    {
+        qint64 lastActivity;
+        qint64 deadline;    ///< key of the host in mAgeQueue
+    };
+    QHash<unsigned int, Age> mAges;
+    /// Hosts by the time they are checked for aging out next
+    QMultiMap<qint64, unsigned int> mAgeQueue;
     QTimer *m_progressTimer;
     QTimer *m_ageTimer;
 
     bool mRunning;
 
     int mUpdateInterval;
-
-    int mMinimumProgressHeight;
 };
 
 #endif
@@ -30,16 +30,19 @@
 #include <qlayout.h>
 #include <qtooltip.h>
 #include <qslider.h>
+#include <qspinbox.h>
 #include <qlabel.h>
 #include <qpushbutton.h>
 #include <qlineedit.h>
-#include <qregexp.h>
 #include <qcheckbox.h>
 #include <qdir.h>
 #include <QSettings>
 #include <QResizeEvent>
 #include <QGraphicsScene>
+#include <QGraphicsSceneHoverEvent>
 #include <QGraphicsView>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
 
 #include <math.h>
 
@@ -72,9 +75,26 @@ StarViewConfigDialog::StarViewConfigDialog(QWidget *parent)
     mNodesPerRingLabel = new QLabel;
     nodesLayout->addWidget(mNodesPerRingLabel);
 
-    label = new QLabel(tr("Architecture filter:"));
+    QBoxLayout *dotsLayout = new QHBoxLayout();
+    topLayout->addLayout(dotsLayout);
+    label = new QLabel(tr("Show hosts as dots above:"));
+    dotsLayout->addWidget(label);
+    mDotsThresholdSpinBox = new QSpinBox;
+    mDotsThresholdSpinBox->setRange(1, 100000);
+    mDotsThresholdSpinBox->setSuffix(tr(" hosts"));
+    label->setBuddy(mDotsThresholdSpinBox);
+    dotsLayout->addWidget(mDotsThresholdSpinBox);
+    connect(mDotsThresholdSpinBox, SIGNAL(valueChanged(int)),
+            SIGNAL(configChanged()));
+
+    label = new QLabel(tr("Host filter:"));
     topLayout->addWidget(label);
     mArchFilterEdit = new QLineEdit;
+    mArchFilterEdit->setPlaceholderText(tr("e.g. x86_64 armv7l host:^build"));
+    mArchFilterEdit->setToolTip(tr("Space separated regular expressions. Hosts are shown if their "
+                                   "platform matches any of the expressions and their name matches "
+                                   "any of those prefixed with \"host:\"."));
+    label->setBuddy(mArchFilterEdit);
     topLayout->addWidget(mArchFilterEdit);
     connect(mArchFilterEdit, SIGNAL(textChanged(const QString &)),
             SIGNAL(configChanged()));
@@ -117,6 +137,16 @@ void StarViewConfigDialog::setNodesPerRing(int nodes)
     configChanged();
 }
 
+int StarViewConfigDialog::dotsThreshold() const
+{
+    return mDotsThresholdSpinBox->value();
+}
+
+void StarViewConfigDialog::setDotsThreshold(int hosts)
+{
+    mDotsThresholdSpinBox->setValue(hosts);
+}
+
 bool StarViewConfigDialog::suppressDomainName() const
 {
     return ::suppressDomain;
@@ -144,6 +174,11 @@ HostItem::HostItem(const QString &text)
     , mHostInfo(nullptr)
     , mHostInfoManager(nullptr)
     , m_stateItem(nullptr)
+    , mNameValid(false)
+    , mDetached(false)
+    , mHasCenterPos(false)
+    , mCenterX(0)
+    , mCenterY(0)
 {
     init();
 
@@ -157,12 +192,18 @@ HostItem::HostItem(HostInfo *hostInfo, HostInfoManager *m)
     , mHostInfo(hostInfo)
     , mHostInfoManager(m)
     , m_stateItem(nullptr)
+    , mNameValid(false)
+    , mDetached(false)
+    , mHasCenterPos(false)
+    , mCenterX(0)
+    , mCenterY(0)
 {
     init();
 }
 
 HostItem::~HostItem()
 {
+    delete m_stateItem;
 }
 
 void HostItem::init()
@@ -203,29 +244,44 @@ QString HostItem::hostName() const
 
 void HostItem::updateName()
 {
-    // Autosize the textItem's width to determine the desired size...
-    m_textItem->setTextWidth(-1);
+    if (mDetached) {
+        // laid out again once the item is attached
+        mNameValid = false;
+        return;
+    }
 
+    QString text;
+    Qt::PenStyle penStyle = Qt::SolidLine;
     if (mHostInfo) {
-        QPen pen = m_boxItem->pen();
-        QString text;
-
         if (mHostInfo->noRemote() || mHostInfo->maxJobs() == 0) {
             text = QStringLiteral("<i>%1</i>").arg(hostName());
-            pen.setStyle(Qt::DotLine);
+            penStyle = Qt::DotLine;
         } else
         {
             text = QStringLiteral("%1<br/>[%2/%3]").arg(hostName()).arg(m_jobs.size()).arg(mHostInfo->maxJobs());
-            pen.setStyle(Qt::SolidLine);
         }
-
-        m_boxItem->setPen(pen);
-        m_textItem->setHtml(text);
     } else
     {
-        m_textItem->setHtml(m_fixedText);
+        text = m_fixedText;
     }
 
+    // laying out the document is expensive, so only do it for new text
+    if (mNameValid && text == m_html) {
+        return;
+    }
+    m_html = text;
+    mNameValid = true;
+
+    // Autosize the textItem's width to determine the desired size...
+    m_textItem->setTextWidth(-1);
+
+    if (mHostInfo) {
+        QPen pen = m_boxItem->pen();
+        pen.setStyle(penStyle);
+        m_boxItem->setPen(pen);
+    }
+    m_textItem->setHtml(text);
+
     QTextBlockFormat format;
     format.setAlignment(Qt::AlignCenter);
     QTextCursor cursor = m_textItem->textCursor();
@@ -243,6 +299,11 @@ void HostItem::updateName()
 
     m_boxItem->setRect(-baseXMargin(), -baseYMargin(), mBaseWidth, mBaseHeight);
 
+    if (mHasCenterPos) {
+        // the size changed, keep the item centered where it was placed
+        setCenterPos(mCenterX, mCenterY);
+    }
+
     updateHalos();
 }
 
@@ -258,6 +319,10 @@ void HostItem::setFixedText(const QString &text)
 
 void HostItem::setCenterPos(double x, double y)
 {
+    mHasCenterPos = true;
+    mCenterX = x;
+    mCenterY = y;
+
     // move all items (also the sub items)
     setPos(x - m_textItem->boundingRect().width() / 2, y - m_textItem->boundingRect().height() / 2);
     //  setPos( x, y );
@@ -287,13 +352,39 @@ void HostItem::update(const Job &job)
 
     if (newJob) {
         m_jobs.insert(job.id, job);
-        createJobHalo(job);
-        updateName();
+        if (!mDetached) {
+            createJobHalo(job);
+            updateName();
+        }
     } else if (finished) {
-        deleteJobHalo(job);
         m_jobs.erase(it);
-        updateName();
+        if (!mDetached) {
+            deleteJobHalo(job);
+            updateName();
+        }
+    }
+}
+
+void HostItem::setDetached(bool detached)
+{
+    if (mDetached == detached) {
+        return;
+    }
+
+    mDetached = detached;
+    if (mDetached) {
+        qDeleteAll(m_jobHalos);
+        m_jobHalos.clear();
+        return;
+    }
+
+    foreach (const Job &job, m_jobs) {
+        auto halo = new QGraphicsEllipseItem(this);
+        halo->setPen(QPen(Qt::NoPen));
+        m_jobHalos.insert(job, halo);
     }
+    updateName();
+    updateHalos();
 }
 
 void HostItem::createJobHalo(const Job &job)
@@ -341,11 +432,143 @@ void HostItem::updateHalos()
     }
 }
 
+HostDotsItem::HostDotsItem(StarView *starView)
+    : QGraphicsItem(nullptr)
+    , m_starView(starView)
+    , m_hoverItem(nullptr)
+{
+    setAcceptHoverEvents(true);
+    // needed for option->exposedRect in paint()
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+void HostDotsItem::setHosts(const QList<HostItem *> &hosts, const HostItem *scheduler)
+{
+    prepareGeometryChange();
+    m_hosts = hosts;
+    m_schedulerPos = scheduler->centerPos();
+    m_boundingRect = (scene() ? scene()->sceneRect() : QRectF());
+    if (!m_hosts.contains(m_hoverItem)) {
+        m_hoverItem = nullptr;
+    }
+    update();
+}
+
+HostItem *HostDotsItem::hostAt(const QPointF &pos) const
+{
+    const qreal maxDistance = DotSize / 2.0 + RingWidth + 2;
+    HostItem *nearest = nullptr;
+    qreal nearestDistance = maxDistance * maxDistance;
+    foreach (HostItem *host, m_hosts) {
+        const QPointF d = host->centerPos() - pos;
+        const qreal distance = d.x() * d.x() + d.y() * d.y();
+        if (distance <= nearestDistance) {
+            nearest = host;
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+
+QRectF HostDotsItem::hostRect(const HostItem *host) const
+{
+    const qreal radius = DotSize / 2.0 + RingWidth + 1;
+    return QRectF(host->centerPos() - QPointF(radius, radius), QSizeF(2 * radius, 2 * radius));
+}
+
+QRectF HostDotsItem::boundingRect() const
+{
+    return m_boundingRect;
+}
+
+void HostDotsItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *)
+{
+    // thousands of small shapes, antialiasing would only make them blurry
+    painter->setRenderHint(QPainter::Antialiasing, false);
+
+    // lines first, so that the dots are drawn on top of them
+    foreach (HostItem *host, m_hosts) {
+        if (!host->isCompiling() && !host->isActiveClient()) {
+            continue;
+        }
+        unsigned int client = host->client();
+        QColor color = client ? m_starView->hostColor(client) : Qt::green;
+        painter->setPen(host->isCompiling() ? QPen(color, 0) : QPen(color, 1, Qt::DashLine));
+        painter->drawLine(host->centerPos(), m_schedulerPos);
+    }
+
+    const qreal dotRadius = DotSize / 2.0;
+    const qreal ringRadius = dotRadius + RingWidth / 2.0;
+    foreach (HostItem *host, m_hosts) {
+        if (!hostRect(host).intersects(option->exposedRect)) {
+            continue;
+        }
+
+        const QPointF center = host->centerPos();
+        const QColor color = host->hostColor();
+        painter->setPen(color.darker(HostItem::PenDarkerFactor));
+        painter->setBrush(color);
+        painter->drawEllipse(center, dotRadius, dotRadius);
+
+        const JobList &jobs = host->jobs();
+        if (jobs.isEmpty()) {
+            continue;
+        }
+
+        // one segment per job slot instead of one halo per job, the angles
+        // are in 1/16th of a degree starting at 12 o'clock
+        const int slots = qMax(jobs.size(), int(host->hostInfo()->maxJobs()));
+        const int span = 360 * 16 / slots;
+        const QRectF ringRect(center - QPointF(ringRadius, ringRadius), QSizeF(2 * ringRadius, 2 * ringRadius));
+        int angle = 90 * 16;
+        painter->setBrush(Qt::NoBrush);
+        for (JobList::ConstIterator it = jobs.constBegin(); it != jobs.constEnd(); ++it) {
+            painter->setPen(QPen(m_starView->hostColor((*it).client), RingWidth, Qt::SolidLine, Qt::FlatCap));
+            painter->drawArc(ringRect, angle, -span);
+            angle -= span;
+        }
+    }
+
+    if (m_hoverItem) {
+        const QString name = m_hoverItem->hostName();
+        const QFontMetricsF fm(painter->font());
+        const QRectF rect = hostRect(m_hoverItem);
+        const QRectF textRect(rect.right() + 2, rect.center().y() - fm.height() / 2,
+                              fm.width(name) + 4, fm.height());
+        painter->setPen(Qt::black);
+        painter->setBrush(m_hoverItem->hostColor());
+        painter->drawRect(textRect);
+        painter->setPen(Utils::textColor(m_hoverItem->hostColor()));
+        painter->drawText(textRect, Qt::AlignCenter, name);
+    }
+}
+
+void HostDotsItem::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
+{
+    HostItem *item = hostAt(event->pos());
+    if (item != m_hoverItem) {
+        m_hoverItem = item;
+        update();
+    }
+}
+
+void HostDotsItem::hoverLeaveEvent(QGraphicsSceneHoverEvent *)
+{
+    if (m_hoverItem) {
+        m_hoverItem = nullptr;
+        update();
+    }
+}
+
 StarView::StarView(QObject *parent)
     : StatusView(parent)
     , m_canvas(new QGraphicsScene)
     , m_widget(new StarViewGraphicsView(m_canvas, this))
 {
+    // the state lines change all the time, maintaining an index costs more
+    // than it saves
+    m_canvas->setItemIndexMethod(QGraphicsScene::NoIndex);
+
     mConfigDialog = new StarViewConfigDialog(m_widget.data());
     connect(mConfigDialog, SIGNAL(configChanged()),
             SLOT(slotConfigChanged()));
@@ -367,6 +590,7 @@ void StarView::readSettings()
     settings.beginGroup(QStringLiteral("view_%1").arg(id()));
     mConfigDialog->setNodesPerRing(settings.value(QStringLiteral("nodesPerRing"), 25).toInt());
     mConfigDialog->setSuppressDomainName(settings.value(QStringLiteral("suppressDomainName"), true).toBool());
+    mConfigDialog->setDotsThreshold(settings.value(QStringLiteral("dotsThreshold"), 250).toInt());
     settings.endGroup();
 }
 
@@ -376,6 +600,7 @@ void StarView::writeSettings()
     settings.beginGroup(QStringLiteral("view_%1").arg(id()));
     settings.setValue(QStringLiteral("nodesPerRing"), mConfigDialog->nodesPerRing());
     settings.setValue(QStringLiteral("suppressDomainName"), mConfigDialog->suppressDomainName());
+    settings.setValue(QStringLiteral("dotsThreshold"), mConfigDialog->dotsThreshold());
     settings.endGroup();
     settings.sync();
 }
@@ -383,7 +608,6 @@ void StarView::writeSettings()
 void StarView::update(const Job &job)
 {
     if (job.state == Job::WaitingForCS) {
-        m_widget->drawNodeStatus();
         return;
     }
 
@@ -404,16 +628,21 @@ void StarView::update(const Job &job)
     QMap<unsigned int, HostItem *>::Iterator it;
     it = mJobMap.find(job.id);
     if (it != mJobMap.end()) {
-        (*it)->update(job);
+        HostItem *jobItem = *it;
+        jobItem->update(job);
         if (finished) {
             mJobMap.erase(it);
             unsigned int clientid = job.client;
             HostItem *clientItem = findHostItem(clientid);
             if (clientItem) {
                 clientItem->setIsActiveClient(false);
+                m_widget->drawState(clientItem);
             }
         }
-        m_widget->drawNodeStatus();
+        m_widget->drawState(jobItem);
+        if (jobItem != hostItem) {
+            m_widget->drawState(hostItem);
+        }
         return;
     }
 
@@ -427,10 +656,11 @@ void StarView::update(const Job &job)
         if (clientItem) {
             clientItem->setClient(clientid);
             clientItem->setIsActiveClient(true);
+            m_widget->drawState(clientItem);
         }
     }
 
-    m_widget->drawNodeStatus();
+    m_widget->drawState(hostItem);
 }
 
 QList<HostItem *> StarView::hostItems() const
@@ -453,6 +683,13 @@ void StarView::setMonitor(Monitor *monitor)
     }
 }
 
+HostInfo::Fields StarView::hostFields() const
+{
+    // the label, the filter and the color
+    return HostInfo::AddedField | HostInfo::NameField | HostInfo::ColorField | HostInfo::PlatformField
+           | HostInfo::MaxJobsField | HostInfo::NoRemoteField;
+}
+
 void StarView::checkNode(unsigned int hostid)
 {
 //  qDebug() << "StarView::checkNode() " << hostid << endl;
@@ -469,6 +706,10 @@ void StarView::checkNode(unsigned int hostid)
     if (!hostItem) {
         createHostItem(hostid);
         m_widget->arrangeItems();
+    } else {
+        // e.g. the maximum number of jobs changed
+        hostItem->updateName();
+        m_widget->drawState(hostItem);
     }
 }
 
@@ -480,6 +721,7 @@ void StarView::removeNode(unsigned int hostid)
 
     if (hostItem && hostItem->hostInfo()->isOffline()) {
         removeItem(hostItem);
+        m_widget->arrangeItems();
     }
 }
 
@@ -489,6 +731,7 @@ void StarView::forceRemoveNode(unsigned int hostid)
 
     if (hostItem) {
         removeItem(hostItem);
+        m_widget->arrangeItems();
     }
 }
 
@@ -510,10 +753,7 @@ void StarView::removeItem(HostItem *hostItem)
         mJobMap.remove(*it2);
     }
 
-    delete hostItem->stateItem();
     delete hostItem;
-
-    m_widget->arrangeItems();
 }
 
 void StarView::updateSchedulerState(Monitor::SchedulerState state)
@@ -526,6 +766,7 @@ void StarView::updateSchedulerState(Monitor::SchedulerState state)
 
         m_hostItems.clear();
         mJobMap.clear();
+        m_filterResults.clear();
     }
 
     m_widget->arrangeItems();
@@ -539,6 +780,7 @@ QWidget *StarView::widget() const
 StarViewGraphicsView::StarViewGraphicsView(QGraphicsScene *scene, StarView *starView, QWidget *parent)
     : QGraphicsView(scene, parent)
     , m_starView(starView)
+    , m_dotsMode(false)
 {
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -551,15 +793,18 @@ StarViewGraphicsView::StarViewGraphicsView(QGraphicsScene *scene, StarView *star
     m_schedulerItem->setZValue(150);
     m_schedulerItem->show();
     arrangeSchedulerItem();
+
+    m_dotsItem = new HostDotsItem(starView);
+    scene->addItem(m_dotsItem);
+    m_dotsItem->setZValue(-300);
+    m_dotsItem->hide();
 }
 
 void StarViewGraphicsView::resizeEvent(QResizeEvent *)
 {
     scene()->setSceneRect(0, 0, width(), height());
 
-    arrangeSchedulerItem();
-    arrangeHostItems();
-    drawNodeStatus();
+    arrangeItems();
 }
 
 bool StarViewGraphicsView::event(QEvent *e)
@@ -571,14 +816,21 @@ bool StarViewGraphicsView::event(QEvent *e)
     QPoint p(static_cast<QHelpEvent *>(e)->pos());
 
     HostItem *item = nullptr;
+    QRectF sceneRect;
     QGraphicsItem *graphicsItem = itemAt(p);
-    if (graphicsItem) {
+    if (graphicsItem == m_dotsItem) {
+        item = m_dotsItem->hostAt(mapToScene(p));
+        if (item) {
+            sceneRect = m_dotsItem->hostRect(item);
+        }
+    } else if (graphicsItem) {
         item = dynamic_cast<HostItem *>(graphicsItem->parentItem());
+        sceneRect = graphicsItem->sceneBoundingRect();
     }
     if (item) {
         HostInfo *hostInfo = item->hostInfo();
         const QPoint gp(static_cast<QHelpEvent *>(e)->globalPos());
-        const QRect itemRect = mapFromScene(graphicsItem->sceneBoundingRect()).boundingRect();
+        const QRect itemRect = mapFromScene(sceneRect).boundingRect();
         if (hostInfo) {
             QToolTip::showText(gp + QPoint(10, 10), hostInfo->toolTip(), this, itemRect);
         } else {
@@ -611,17 +863,28 @@ void StarViewGraphicsView::arrangeSchedulerItem()
 
 void StarView::slotConfigChanged()
 {
+    const QString filter = mConfigDialog->archFilter();
+    if (filter != m_hostFilter.pattern()) {
+        m_hostFilter = HostFilter(filter);
+        m_filterResults.clear();
+    }
+
     if (!hostInfoManager()) {
         return;
     }
 
-    HostInfoManager::HostMap hostMap = hostInfoManager()->hostMap();
-    HostInfoManager::HostMap::ConstIterator it;
-    for (it = hostMap.constBegin(); it != hostMap.constEnd(); ++it) {
-        if (filterArch(*it)) {
-            checkNode(it.key());
+    const HostSnapshot hosts = hostInfoManager()->hosts();
+    for (HostSnapshot::ConstIterator it = hosts.constBegin(); it != hosts.constEnd(); ++it) {
+        // arrange the items only once below
+        HostItem *hostItem = findHostItem((*it)->id());
+        if (!filterArch(*it)) {
+            if (hostItem) {
+                removeItem(hostItem);
+            }
+        } else if (!hostItem) {
+            createHostItem((*it)->id());
         } else {
-            forceRemoveNode(it.key());
+            hostItem->updateName();
         }
     }
 
@@ -632,6 +895,9 @@ void StarViewGraphicsView::arrangeItems()
 {
     arrangeHostItems();
     arrangeSchedulerItem();
+    m_dotsItem->setHosts(m_dotsMode ? m_starView->hostItems() : QList<HostItem *>(), m_schedulerItem);
+    m_dotsItem->setVisible(m_dotsMode);
+    drawNodeStatus();
 }
 
 void StarViewGraphicsView::arrangeHostItems()
@@ -654,6 +920,10 @@ void StarViewGraphicsView::arrangeHostItems()
 
     const double step = 2 * M_PI / count;
 
+    // beyond the threshold the items are only kept for their state and the
+    // hosts are drawn by m_dotsItem
+    m_dotsMode = count > m_starView->configDialog()->dotsThreshold();
+
     double angle = 0.0;
     int i = 0;
     foreach(HostItem * item, hostItems) {
@@ -662,9 +932,14 @@ void StarViewGraphicsView::arrangeHostItems()
         double xr = xRadius * factor;
         double yr = yRadius * factor;
 
-        item->updateName();
         item->setCenterPos(width() / 2 + cos(angle) * xr,
                            height() / 2 + sin(angle) * yr);
+        if (m_dotsMode && item->scene()) {
+            scene()->removeItem(item);
+        } else if (!m_dotsMode && !item->scene()) {
+            scene()->addItem(item);
+        }
+        item->setDetached(m_dotsMode);
 
         angle += step;
         ++i;
@@ -684,8 +959,13 @@ HostItem *StarView::createHostItem(unsigned int hostid)
     //assert( !i->name().isEmpty() );
 
     auto hostItem = new HostItem(i, hostInfoManager());
-    m_canvas->addItem(hostItem);
+    if (m_widget->isDotsMode()) {
+        hostItem->setDetached(true);
+    } else {
+        m_canvas->addItem(hostItem);
+    }
     hostItem->setHostColor(hostColor(hostid));
+    hostItem->updateName();
     m_hostItems.insert(hostid, hostItem);
     hostItem->show();
 
@@ -706,35 +986,51 @@ void StarViewGraphicsView::drawNodeStatus()
 
 void StarViewGraphicsView::drawState(HostItem *node)
 {
-    delete node->stateItem();
-    QGraphicsLineItem *newItem = nullptr;
+    QGraphicsLineItem *lineItem = node->stateItem();
+    if (m_dotsMode) {
+        // the line is drawn by m_dotsItem
+        if (lineItem) {
+            lineItem->hide();
+        }
+        m_dotsItem->update();
+        return;
+    }
+    if (!node->isCompiling() && !node->isActiveClient()) {
+        if (lineItem) {
+            lineItem->hide();
+        }
+        return;
+    }
+
+    if (!lineItem) {
+        lineItem = new QGraphicsLineItem;
+        scene()->addItem(lineItem);
+        node->setStateItem(lineItem);
+    }
 
     unsigned int client = node->client();
     QColor color = client ? m_starView->hostColor(client) : Qt::green;
 
-    if (node->isCompiling() || node->isActiveClient()) {
-        newItem = new QGraphicsLineItem(qRound(node->centerPosX()),
-                                        qRound(node->centerPosY()),
-                                        qRound(m_schedulerItem->centerPosX()),
-                                        qRound(m_schedulerItem->centerPosY()));
-        if (node->isCompiling()) {
-            newItem->setPen(QPen(color, 0));
-            newItem->setZValue(-301);
-        } else if (node->isActiveClient()) {
-            newItem->setPen(QPen(color, 1, Qt::DashLine));
-            newItem->setZValue(-300);
-        }
-        scene()->addItem(newItem);
+    // the setters do nothing if the value did not change
+    lineItem->setLine(qRound(node->centerPosX()),
+                      qRound(node->centerPosY()),
+                      qRound(m_schedulerItem->centerPosX()),
+                      qRound(m_schedulerItem->centerPosY()));
+    if (node->isCompiling()) {
+        lineItem->setPen(QPen(color, 0));
+        lineItem->setZValue(-301);
+    } else {
+        lineItem->setPen(QPen(color, 1, Qt::DashLine));
+        lineItem->setZValue(-300);
     }
-
-    node->setStateItem(newItem);
+    lineItem->show();
 }
 
 void StarView::createKnownHosts()
 {
-    HostInfoManager::HostMap hosts = hostInfoManager()->hostMap();
+    const HostSnapshot hosts = hostInfoManager()->hosts();
 
-    HostInfoManager::HostMap::ConstIterator it;
+    HostSnapshot::ConstIterator it;
     for (it = hosts.constBegin(); it != hosts.constEnd(); ++it) {
         unsigned int id = (*it)->id();
         if (!findHostItem(id)) {
@@ -761,17 +1057,22 @@ bool StarView::filterArch(unsigned int hostid)
 
 bool StarView::filterArch(HostInfo *i)
 {
-    if (mConfigDialog->archFilter().isEmpty()) {
+    if (m_hostFilter.isEmpty()) {
         return true;
     }
 
-    QRegExp regExp(mConfigDialog->archFilter());
-
-    if (regExp.indexIn(i->platform()) >= 0) {
-        return true;
+    QHash<unsigned int, FilterResult>::ConstIterator it = m_filterResults.constFind(i->id());
+    if (it != m_filterResults.constEnd()
+        && (*it).platform == i->platform() && (*it).name == i->name()) {
+        return (*it).matches;
     }
 
-    return false;
+    FilterResult result;
+    result.platform = i->platform();
+    result.name = i->name();
+    result.matches = m_hostFilter.matches(result.name, result.platform);
+    m_filterResults.insert(i->id(), result);
+    return result.matches;
 }
 
 StarViewConfigDialog *StarView::configDialog() const
@@ -21,10 +21,12 @@
 #ifndef ICEMON_STARVIEW_H
 #define ICEMON_STARVIEW_H
 
+#include "hostfilter.h"
 #include "job.h"
 #include "statusview.h"
 
 #include <QGraphicsView>
+#include <QHash>
 #include <QResizeEvent>
 #include <QLabel>
 #include <QGraphicsEllipseItem>
@@ -34,6 +36,7 @@ class HostInfo;
 class StarView;
 
 class QSlider;
+class QSpinBox;
 class QLabel;
 class QLineEdit;
 class QCheckBox;
@@ -55,6 +58,10 @@ public:
 
     void setMaxNodes(int);
 
+    /// Hosts are drawn as dots if there are more than this
+    int dotsThreshold() const;
+    void setDotsThreshold(int hosts);
+
     QString archFilter();
 
 protected slots:
@@ -67,6 +74,7 @@ signals:
 private:
     QSlider *mNodesPerRingSlider;
     QLabel *mNodesPerRingLabel;
+    QSpinBox *mDotsThresholdSpinBox;
     QLineEdit *mArchFilterEdit;
     QCheckBox *mSuppressDomainName;
 };
@@ -89,6 +97,7 @@ public:
     HostInfo *hostInfo() const { return mHostInfo; }
 
     void setHostColor(const QColor &color);
+    QColor hostColor() const { return m_boxItem->brush().color(); }
 
     void setIsActiveClient(bool active) { mIsActiveClient = active; }
     bool isActiveClient() const { return mIsActiveClient; }
@@ -96,13 +105,15 @@ public:
     void setIsCompiling(bool compiling) { mIsCompiling = compiling; }
     bool isCompiling() const { return mIsCompiling; }
 
-    void setStateItem(QGraphicsItem *item) { m_stateItem = item; }
-    QGraphicsItem *stateItem() { return m_stateItem; }
+    /// The line to the scheduler, owned by the item and reused while it lives
+    void setStateItem(QGraphicsLineItem *item) { m_stateItem = item; }
+    QGraphicsLineItem *stateItem() { return m_stateItem; }
 
     void setClient(unsigned int client) { m_client = client; }
     unsigned int client() const { return m_client; }
 
     QString hostName() const;
+    /// Rebuild the label, only does something if its text changed
     void updateName();
     void setFixedText(const QString &text);
 
@@ -116,8 +127,18 @@ public:
     qreal baseYMargin() const { return (mBaseHeight - m_textItem->boundingRect().height()) / 2; }
 
     void setCenterPos(double x, double y);
+    /// The position last passed to setCenterPos()
+    QPointF centerPos() const { return QPointF(mCenterX, mCenterY); }
 
     void update(const Job &job);
+    const JobList &jobs() const { return m_jobs; }
+
+    /**
+     * Detached items are not in the scene, they are drawn by HostDotsItem.
+     * They only track their jobs, without halos or label layout.
+     */
+    void setDetached(bool detached);
+    bool isDetached() const { return mDetached; }
 
 protected:
     void createJobHalo(const Job &);
@@ -131,9 +152,16 @@ private:
     bool mIsActiveClient;
     bool mIsCompiling;
 
-    QGraphicsItem *m_stateItem;
+    QGraphicsLineItem *m_stateItem;
     QGraphicsTextItem *m_textItem;
     QString m_fixedText;
+    QString m_html;
+    bool mNameValid;
+    bool mDetached;
+
+    bool mHasCenterPos;
+    double mCenterX;
+    double mCenterY;
     unsigned int m_client;
 
     qreal mBaseWidth;
@@ -146,6 +174,46 @@ private:
     JobList m_jobs;
 };
 
+/**
+ * Draws hosts as dots in a single item, for farms too large for HostItems
+ *
+ * The jobs of a host are drawn as a ring around its dot, with one segment
+ * per job slot colored by the client. Lines to the scheduler are drawn in
+ * the same pass, names are only shown for the host under the mouse.
+ */
+class HostDotsItem
+    : public QGraphicsItem
+{
+public:
+    enum {
+        DotSize = 6,
+        RingWidth = 2
+    };
+
+    explicit HostDotsItem(StarView *starView);
+
+    /// The positions of @p hosts and @p scheduler have to be set already
+    void setHosts(const QList<HostItem *> &hosts, const HostItem *scheduler);
+
+    HostItem *hostAt(const QPointF &pos) const;
+    /// Scene rect of the dot and the ring of @p host
+    QRectF hostRect(const HostItem *host) const;
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+protected:
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent *event) override;
+
+private:
+    StarView *m_starView;
+    QList<HostItem *> m_hosts;
+    QPointF m_schedulerPos;
+    QRectF m_boundingRect;
+    HostItem *m_hoverItem;
+};
+
 class StarViewGraphicsView
     : public QGraphicsView
 {
@@ -156,6 +224,11 @@ public:
 
     void arrangeItems();
     void drawNodeStatus();
+    /// Update the line of @p node to the scheduler in place
+    void drawState(HostItem *node);
+
+    /// Whether the hosts are drawn by a HostDotsItem
+    bool isDotsMode() const { return m_dotsMode; }
 
 protected:
     virtual void resizeEvent(QResizeEvent *e) override;
@@ -164,10 +237,11 @@ protected:
 private:
     void arrangeHostItems();
     void arrangeSchedulerItem();
-    void drawState(HostItem *node);
 
     StarView *m_starView;
     HostItem *m_schedulerItem;
+    HostDotsItem *m_dotsItem;
+    bool m_dotsMode;
 };
 
 class StarView
@@ -186,6 +260,7 @@ public:
     virtual QWidget *widget() const override;
 
     QString id() const override { return QStringLiteral("star"); }
+    HostInfo::Fields hostFields() const override;
 
     QList<HostItem *> hostItems() const;
     HostItem *findHostItem(unsigned int hostid) const;
@@ -207,9 +282,12 @@ public:
     bool filterArch(unsigned int hostid);
     /**
        Return true if node should be shown and false if not.
+
+       The result is cached until the platform or name of the host changes.
      */
     bool filterArch(HostInfo *);
 
+    /// Does not rearrange the remaining items
     void removeItem(HostItem *);
     void forceRemoveNode(unsigned int hostid);
 
@@ -226,6 +304,15 @@ private:
 
     QMap<unsigned int, HostItem *> m_hostItems;
     QMap<unsigned int, HostItem *> mJobMap;
+
+    HostFilter m_hostFilter;
+    struct FilterResult
+    {
+        QString platform;
+        QString name;
+        bool matches;
+    };
+    QHash<unsigned int, FilterResult> m_filterResults;
 };
 
 #endif
@@ -22,247 +22,433 @@
 
 #include "hostinfo.h"
 #include "job.h"
+#include "monitor.h"
 
 #include <qdebug.h>
 
-#include <qlabel.h>
-#include <qlayout.h>
 #include <qpainter.h>
-#include <QScrollBar>
+#include <QAbstractScrollArea>
 #include <QApplication>
+#include <QHelpEvent>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QToolTip>
+
+#include <algorithm>
+
+namespace {
 
-class NodeInfoFrame
-    : public QFrame
+const int OUTER_MARGIN = 5;
+const int SPACING = 5;
+const int BOX_MARGIN = 10;
+const int BORDER_WIDTH = 2;
+const int MIN_LEFT_WIDTH = 75;
+const int SLOT_BAR_HEIGHT = 15;
+const int SLOT_SPACER_HEIGHT = 8;
+/// "job time:", four percentiles and the number of requested jobs
+const int SPEED_LINES = 6;
+
+}
+
+/**
+ * Paints all hosts of the summary into one viewport
+ *
+ * Every host is a box with its name, its job time as a client and one bar
+ * per job slot on the left, and the jobs it runs as a server on the right.
+ * The height of a host only depends on its number of job slots, so the layout
+ * only changes when hosts come or go, and only the visible hosts are
+ * painted.
+ */
+class SummaryViewWidget
+    : public QAbstractScrollArea
 {
 public:
-    NodeInfoFrame(QWidget *parent, const QColor &frameColor)
-        : QFrame(parent)
-        , m_frameColor(frameColor)
-    {
-        setObjectName(QStringLiteral("nodeInfoFrame"));
-        setStyleSheet(QStringLiteral("QFrame#nodeInfoFrame { border: 2px solid %1 }").arg(frameColor.name()));
-    }
+    explicit SummaryViewWidget(SummaryView *view);
+
+    void addItem(SummaryViewItem *item);
+    void removeItem(SummaryViewItem *item);
+    /// Schedule painting @p item again if it is visible
+    void updateItem(const SummaryViewItem *item);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    bool viewportEvent(QEvent *event) override;
+
 private:
-    QColor m_frameColor;
+    void relayout();
+    void updateScrollBar();
+    int itemHeight(const SummaryViewItem *item) const;
+    /// Index of the first item that ends below content position @p y
+    int indexAt(int y) const;
+    QRect leftRect(int index) const;
+    QRect rightRect(int index) const;
+    void paintItem(QPainter &p, const SummaryViewItem *item, int index);
+    void drawLine(QPainter &p, int x, int y, int width, const QString &caption, const QString &text);
+
+    SummaryView *m_view;
+    QVector<SummaryViewItem *> m_items;
+    QVector<int> m_tops;        ///< content position of each item
+    QVector<int> m_bottoms;
+    int m_contentHeight;
+    int m_lineHeight;
+    int m_leftWidth;
+    int m_captionWidth;
 };
 
-class SummaryViewScrollArea
-    : public QScrollArea
+SummaryViewWidget::SummaryViewWidget(SummaryView *view)
+    : m_view(view)
+    , m_contentHeight(0)
+    , m_lineHeight(0)
+    , m_leftWidth(MIN_LEFT_WIDTH)
+    , m_captionWidth(0)
 {
-public:
-    explicit SummaryViewScrollArea(QWidget *parent = nullptr);
+    QPalette pal = viewport()->palette();
+    pal.setColor(viewport()->backgroundRole(), Qt::white);
+    pal.setColor(viewport()->foregroundRole(), Qt::black);
+    viewport()->setPalette(pal);
+    viewport()->setAutoFillBackground(true);
+
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setMinimumHeight(150);
+    relayout();
+}
 
-    virtual void resizeEvent(QResizeEvent *) override;
-};
+void SummaryViewWidget::addItem(SummaryViewItem *item)
+{
+    item->setIndex(m_items.size());
+    m_items.append(item);
+
+    const int top = (m_bottoms.isEmpty() ? OUTER_MARGIN : m_bottoms.last() + SPACING);
+    m_tops.append(top);
+    m_bottoms.append(top + itemHeight(item));
+    m_contentHeight = m_bottoms.last() + OUTER_MARGIN;
+    updateScrollBar();
+    viewport()->update();
+}
 
-////////////////////////////////////////////////////////////////////////////////
-// SummaryViewItem implementation
-////////////////////////////////////////////////////////////////////////////////
+void SummaryViewWidget::removeItem(SummaryViewItem *item)
+{
+    m_items.remove(item->index());
+    for (int i = item->index(); i < m_items.size(); ++i) {
+        m_items.at(i)->setIndex(i);
+    }
+    relayout();
+}
 
-SummaryViewItem::SummaryViewItem(unsigned int hostid, QWidget *parent, SummaryView *view, QGridLayout *layout)
-    : m_jobCount(0)
-    , m_totalJobsLength(0.0f)
-    , m_finishedJobCount(0)
-    , m_totalRequestedJobsLength(0.0f)
-    , m_requestedJobCount(0)
-    , m_view(view)
+void SummaryViewWidget::updateItem(const SummaryViewItem *item)
 {
-    const int row = layout->rowCount();
-    const QColor nodeColor = view->hostInfoManager()->hostColor(hostid);
-
-    auto labelBox = new NodeInfoFrame(parent, nodeColor);
-    layout->setMargin(5);
-    layout->addWidget(labelBox, row, 0);
-    labelBox->show();
-    labelBox->setMinimumWidth(75);
-    m_widgets.append(labelBox);
-
-    auto labelLayout = new QVBoxLayout(labelBox);
-    labelLayout->setMargin(10);
-    labelLayout->setSpacing(5);
-
-    QLabel *l;
-
-    l = new QLabel(view->nameForHost(hostid), labelBox);
-    l->setAlignment(Qt::AlignCenter);
-    l->show();
-    labelLayout->addWidget(l);
-
-    m_speedLabel = new QLabel(labelBox);
-    m_speedLabel->setToolTip(QApplication::tr("Average job time for a file sent by this client / total number of jobs sent."));
-    m_speedLabel->setAlignment(Qt::AlignCenter);
-    m_speedLabel->show();
-    labelLayout->addWidget(m_speedLabel);
-
-    const int maxJobs = view->hostInfoManager()->maxJobs(hostid);
-
-    m_jobHandlers.resize(maxJobs);
-
-    for (int i = 0; i < maxJobs; i++) {
-        m_jobHandlers[i].stateWidget = new QFrame(labelBox);
-        m_jobHandlers[i].stateWidget->setFrameStyle(QFrame::Box | QFrame::Plain);
-        m_jobHandlers[i].stateWidget->setLineWidth(2);
-        m_jobHandlers[i].stateWidget->setFixedHeight(15);
-        QPalette palette = m_jobHandlers[i].stateWidget->palette();
-        palette.setColor(m_jobHandlers[i].stateWidget->foregroundRole(), Qt::black);
-        m_jobHandlers[i].stateWidget->setPalette(palette);
-        m_jobHandlers[i].stateWidget->show();
-        labelLayout->addWidget(m_jobHandlers[i].stateWidget);
+    const int scroll = verticalScrollBar()->value();
+    const QRect rect(0, m_tops.at(item->index()) - scroll,
+                     viewport()->width(), m_bottoms.at(item->index()) - m_tops.at(item->index()));
+    if (rect.intersects(viewport()->rect())) {
+        viewport()->update(rect);
     }
+}
 
-    auto detailsBox = new NodeInfoFrame(parent, nodeColor);
-    layout->setMargin(5);
-    layout->addWidget(detailsBox, row, 1);
-    detailsBox->show();
-    m_widgets.append(detailsBox);
+void SummaryViewWidget::relayout()
+{
+    const QFontMetrics fm(viewport()->font());
+    m_lineHeight = fm.height();
+    m_leftWidth = qMax(MIN_LEFT_WIDTH,
+                       fm.width(QApplication::tr("requested jobs count: %2").arg(99999)) + 2 * BOX_MARGIN);
+    m_captionWidth = qMax(fm.width(QApplication::tr("Jobs:")),
+                          qMax(fm.width(QApplication::tr("Source:")), fm.width(QApplication::tr("State:"))));
+
+    m_tops.resize(m_items.size());
+    m_bottoms.resize(m_items.size());
+    int y = OUTER_MARGIN;
+    for (int i = 0; i < m_items.size(); ++i) {
+        m_tops[i] = y;
+        y += itemHeight(m_items.at(i));
+        m_bottoms[i] = y;
+        y += SPACING;
+    }
+    m_contentHeight = (m_items.isEmpty() ? 0 : y - SPACING + OUTER_MARGIN);
 
-    auto grid = new QGridLayout(detailsBox);
-    grid->setMargin(10);
-    grid->setSpacing(5);
+    updateScrollBar();
+    viewport()->update();
+}
 
-    m_jobsLabel = addLine(QApplication::tr("Jobs:"), detailsBox, grid, Qt::AlignBottom, QStringLiteral("0"));
-    m_jobsLabel->setToolTip(QApplication::tr("Total number of jobs processed by this server / average duration of each job."));
+void SummaryViewWidget::updateScrollBar()
+{
+    const int height = viewport()->height();
+    verticalScrollBar()->setPageStep(height);
+    verticalScrollBar()->setSingleStep(m_lineHeight);
+    verticalScrollBar()->setRange(0, qMax(0, m_contentHeight - height));
+}
 
-    for (int i = 0; i < maxJobs; i++) {
-        if (maxJobs > 1) {
-            auto spacer  = new QSpacerItem(1, 8, QSizePolicy::Expanding);
-            const int row = grid->rowCount();
-            grid->addItem(spacer, row, 0, 1, grid->columnCount() - 1);
+int SummaryViewWidget::itemHeight(const SummaryViewItem *item) const
+{
+    const int slotCount = item->jobSlots().size();
+    const int left = 2 * BOX_MARGIN + m_lineHeight + SPACING + SPEED_LINES * m_lineHeight
+                     + slotCount * (SLOT_BAR_HEIGHT + SPACING);
+    const int slotHeight = (slotCount > 1 ? SLOT_SPACER_HEIGHT + SPACING : 0) + 2 * (m_lineHeight + SPACING);
+    const int right = 2 * BOX_MARGIN + m_lineHeight + slotCount * slotHeight;
+    return qMax(left, right);
+}
+
+int SummaryViewWidget::indexAt(int y) const
+{
+    return int(std::upper_bound(m_bottoms.constBegin(), m_bottoms.constEnd(), y) - m_bottoms.constBegin());
+}
+
+QRect SummaryViewWidget::leftRect(int index) const
+{
+    const int top = m_tops.at(index) - verticalScrollBar()->value();
+    return QRect(OUTER_MARGIN, top, m_leftWidth, m_bottoms.at(index) - m_tops.at(index));
+}
+
+QRect SummaryViewWidget::rightRect(int index) const
+{
+    const QRect left = leftRect(index);
+    const int x = left.right() + 1 + SPACING;
+    return QRect(x, left.top(), viewport()->width() - OUTER_MARGIN - x, left.height());
+}
+
+void SummaryViewWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter p(viewport());
+    const int scroll = verticalScrollBar()->value();
+    const int end = scroll + event->rect().bottom();
+    for (int i = indexAt(scroll + event->rect().top()); i < m_items.size() && m_tops.at(i) <= end; ++i) {
+        paintItem(p, m_items.at(i), i);
+    }
+}
+
+void SummaryViewWidget::paintItem(QPainter &p, const SummaryViewItem *item, int index)
+{
+    const QColor nodeColor = m_view->hostInfoManager()->hostColor(item->hostId());
+    const QRect left = leftRect(index);
+    const QRect right = rightRect(index);
+
+    p.setBrush(Qt::NoBrush);
+    p.setPen(QPen(nodeColor, BORDER_WIDTH));
+    // the pen is centered on the outline, keep it inside the box
+    p.drawRect(left.adjusted(1, 1, -1, -1));
+    p.drawRect(right.adjusted(1, 1, -1, -1));
+
+    const QFontMetrics fm = p.fontMetrics();
+    const int width = left.width() - 2 * BOX_MARGIN;
+    int x = left.left() + BOX_MARGIN;
+    int y = left.top() + BOX_MARGIN;
+
+    p.setPen(Qt::black);
+    p.drawText(x, y, width, m_lineHeight, Qt::AlignCenter,
+               fm.elidedText(m_view->nameForHost(item->hostId()), Qt::ElideRight, width));
+    y += m_lineHeight + SPACING;
+    p.drawText(x, y, width, SPEED_LINES * m_lineHeight, Qt::AlignHCenter | Qt::AlignTop, item->speedText());
+    y += SPEED_LINES * m_lineHeight + SPACING;
+
+    const QVector<SummaryViewItem::JobSlot> &jobSlots = item->jobSlots();
+    foreach (const SummaryViewItem::JobSlot &slot, jobSlots) {
+        p.setPen(QPen(slot.busy ? slot.color : QColor(Qt::black), BORDER_WIDTH));
+        p.drawRect(QRect(x, y, width, SLOT_BAR_HEIGHT).adjusted(1, 1, -1, -1));
+        y += SLOT_BAR_HEIGHT + SPACING;
+    }
+
+    x = right.left() + BOX_MARGIN;
+    y = right.top() + BOX_MARGIN;
+    const int lineWidth = right.width() - 2 * BOX_MARGIN;
+    p.setPen(Qt::black);
+    drawLine(p, x, y, lineWidth, QApplication::tr("Jobs:"), item->jobsText());
+    y += m_lineHeight;
+    foreach (const SummaryViewItem::JobSlot &slot, jobSlots) {
+        if (jobSlots.size() > 1) {
+            y += SLOT_SPACER_HEIGHT + SPACING;
         }
-        m_jobHandlers[i].sourceLabel = addLine(QApplication::tr("Source:"), detailsBox, grid);
-        m_jobHandlers[i].stateLabel = addLine(QApplication::tr("State:"), detailsBox, grid);
+        drawLine(p, x, y, lineWidth, QApplication::tr("Source:"), slot.source);
+        y += m_lineHeight + SPACING;
+        drawLine(p, x, y, lineWidth, QApplication::tr("State:"), slot.state);
+        y += m_lineHeight + SPACING;
     }
+}
 
-    grid->setColumnStretch(grid->columnCount() - 1, 1);
-    grid->setRowStretch(0, 1);
-    grid->setRowStretch(grid->rowCount(), 1);
+void SummaryViewWidget::drawLine(QPainter &p, int x, int y, int width, const QString &caption, const QString &text)
+{
+    p.drawText(x, y, m_captionWidth, m_lineHeight, Qt::AlignRight | Qt::AlignVCenter, caption);
+    const int textX = x + m_captionWidth + SPACING;
+    const int textWidth = width - m_captionWidth - SPACING;
+    if (textWidth > 0 && !text.isEmpty()) {
+        p.drawText(textX, y, textWidth, m_lineHeight, Qt::AlignLeft | Qt::AlignVCenter,
+                   p.fontMetrics().elidedText(text, Qt::ElideRight, textWidth));
+    }
 }
 
-SummaryViewItem::~SummaryViewItem()
+void SummaryViewWidget::resizeEvent(QResizeEvent *event)
 {
-    qDeleteAll(m_widgets);
-    m_widgets.clear();
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
 }
 
-void SummaryViewItem::updateStats()
+void SummaryViewWidget::changeEvent(QEvent *event)
 {
-    const double avgDuration = m_finishedJobCount > 0 ? m_totalJobsLength / m_finishedJobCount : 0.0f;
-    m_jobsLabel->setText(QApplication::tr("%1 (Ø duration: %2 ms)").arg(
+    QAbstractScrollArea::changeEvent(event);
+    if (event->type() == QEvent::FontChange) {
+        relayout();
+    }
+}
+
+void SummaryViewWidget::scrollContentsBy(int, int)
+{
+    viewport()->update();
+}
+
+bool SummaryViewWidget::viewportEvent(QEvent *event)
+{
+    if (event->type() != QEvent::ToolTip) {
+        return QAbstractScrollArea::viewportEvent(event);
+    }
+
+    const QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
+    const QPoint pos = helpEvent->pos();
+    const int index = indexAt(pos.y() + verticalScrollBar()->value());
+    QString toolTip;
+    QRect rect;
+    if (index < m_items.size()) {
+        const QRect left = leftRect(index);
+        const QRect right = rightRect(index);
+        const QRect speedRect(left.left(), left.top() + BOX_MARGIN + m_lineHeight + SPACING,
+                              left.width(), SPEED_LINES * m_lineHeight);
+        const QRect jobsRect(right.left(), right.top() + BOX_MARGIN, right.width(), m_lineHeight);
+        if (speedRect.contains(pos)) {
+            toolTip = QApplication::tr("Percentiles of the job time for files sent by this client / total number of jobs sent.");
+            rect = speedRect;
+        } else if (jobsRect.contains(pos)) {
+            toolTip = QApplication::tr("Total number of jobs processed by this server / percentiles of the job duration.");
+            rect = jobsRect;
+        }
+    }
+
+    if (toolTip.isEmpty()) {
+        QToolTip::hideText();
+        event->ignore();
+    } else {
+        QToolTip::showText(helpEvent->globalPos(), toolTip, viewport(), rect);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SummaryViewItem implementation
+////////////////////////////////////////////////////////////////////////////////
+
+SummaryViewItem::SummaryViewItem(unsigned int hostid, SummaryView *view)
+    : m_hostId(hostid)
+    , m_jobCount(0)
+    , m_index(-1)
+    , m_view(view)
+    , m_statsDirty(true)
+{
+    m_jobSlots.resize(view->hostInfoManager()->maxJobs(hostid));
+}
+
+QString SummaryViewItem::jobsText() const
+{
+    if (m_statsDirty) {
+        updateStats();
+    }
+    return m_jobsText;
+}
+
+QString SummaryViewItem::speedText() const
+{
+    if (m_statsDirty) {
+        updateStats();
+    }
+    return m_speedText;
+}
+
+void SummaryViewItem::updateStats() const
+{
+    m_statsDirty = false;
+    const JobStatistics &statistics = m_view->monitor()->jobStatistics();
+
+    const JobStatistics::Histograms *server = statistics.server(m_hostId);
+    m_jobsText = QApplication::tr("%1 (duration: %2)").arg(
         QString::number(m_jobCount),
-        QString::number(avgDuration, 'f', 0)
-    ));
+        server ? JobStatistics::durationSummary(server->realTime) : QString::number(0)
+    );
 
-    const double avgTime = m_requestedJobCount > 0 ? m_totalRequestedJobsLength / m_requestedJobCount : 0.0f;
-    if (qIsNull(avgTime)) {
-        m_speedLabel->setText(QString());
+    const JobStatistics::Histograms *client = statistics.client(m_hostId);
+    if (!client) {
+        m_speedText = QString();
     } else {
-        m_speedLabel->setText(QApplication::tr("Ø job time: %1 ms\nrequested jobs count: %2").arg(
-            QString::number(avgTime, 'f', 0),
-            QString::number(m_requestedJobCount)
-        ));
+        m_speedText = QApplication::tr("job time:\n%1\nrequested jobs count: %2").arg(
+            JobStatistics::durationSummary(client->realTime, QStringLiteral("\n")),
+            QString::number(client->realTime.count())
+        );
     }
 }
 
-void SummaryViewItem::updateClient(const Job &job)
+bool SummaryViewItem::updateClient(const Job &job)
 {
     if (job.state == Job::Finished) {
-	m_totalRequestedJobsLength += job.real_msec;
-	m_requestedJobCount++;
-	updateStats();
+        m_statsDirty = true;
+        return true;
     }
+    return false;
 }
 
-void SummaryViewItem::update(const Job &job)
+bool SummaryViewItem::update(const Job &job)
 {
     switch (job.state) {
     case Job::Compiling:
     {
+        if (m_runningJobs.contains(job.id)) {
+            return false;
+        }
+        m_runningJobs.insert(job.id);
         m_jobCount++;
-        updateStats();
+        m_statsDirty = true;
 
-        QVector<JobHandler>::Iterator it = m_jobHandlers.begin();
-        while (it != m_jobHandlers.end() && !(*it).currentFile.isNull())
+        QVector<JobSlot>::Iterator it = m_jobSlots.begin();
+        while (it != m_jobSlots.end() && (*it).busy)
             ++it;
 
-        if (it != m_jobHandlers.end()) {
-            const QColor nodeColor = m_view->hostInfoManager()->hostColor(job.client);
-            QPalette palette = (*it).stateWidget->palette();
-            palette.setColor((*it).stateWidget->foregroundRole(), nodeColor);
-            (*it).stateWidget->setPalette(palette);
-            const QString fileName = job.fileName.section(QLatin1Char('/'), -1);
+        if (it != m_jobSlots.end()) {
+            const QString fileName = job.fileName().section(QLatin1Char('/'), -1);
             const QString hostName = m_view->nameForHost(job.client);
-            (*it).sourceLabel->setText(QStringLiteral("%1 (%2)").arg(fileName).arg(hostName));
-            (*it).stateLabel->setText(job.stateAsString());
-            (*it).currentFile = job.fileName;
+            (*it).color = m_view->hostInfoManager()->hostColor(job.client);
+            (*it).source = QStringLiteral("%1 (%2)").arg(fileName).arg(hostName);
+            (*it).state = job.stateAsString();
+            (*it).fileId = job.fileId;
+            (*it).busy = true;
         }
-        break;
+        return true;
     }
     case Job::Finished:
     case Job::Failed:
     {
-        QVector<JobHandler>::Iterator it = m_jobHandlers.begin();
-        while (it != m_jobHandlers.end() && (*it).currentFile != job.fileName)
+        // batches only carry the latest state of a job, count the jobs
+        // which were never seen compiling here
+        const bool counted = !m_runningJobs.remove(job.id);
+        if (counted) {
+            m_jobCount++;
+            m_statsDirty = true;
+        }
+
+        QVector<JobSlot>::Iterator it = m_jobSlots.begin();
+        while (it != m_jobSlots.end() && !((*it).busy && (*it).fileId == job.fileId))
             ++it;
 
-        if (it != m_jobHandlers.end()) {
-            QPalette palette = (*it).stateWidget->palette();
-            palette.setColor((*it).stateWidget->foregroundRole(), Qt::black);
-            (*it).stateWidget->setPalette(palette);
-	    (*it).stateWidget->repaint();
-            (*it).sourceLabel->clear();
-            (*it).stateLabel->setText(job.stateAsString());
-            (*it).currentFile = QString();
-	    if (job.state == Job::Finished) {
-	      m_totalJobsLength += job.real_msec;
-	      m_finishedJobCount++;
-	      updateStats();
-	    }
+        if (it != m_jobSlots.end()) {
+            (*it).source.clear();
+            (*it).state = job.stateAsString();
+            (*it).busy = false;
+            if (job.state == Job::Finished) {
+                m_statsDirty = true;
+            }
+            return true;
         }
-        break;
+        return counted;
     }
     default:
         break;
     }
-}
-
-QLabel *SummaryViewItem::addLine(const QString &caption, QWidget *parent,
-                                 QGridLayout *grid, Qt::Alignment flags,
-                                 const QString &status)
-{
-    auto label = new QLabel(caption, parent);
-    label->setAlignment(Qt::AlignRight | flags);
-    const int row = grid->rowCount();
-    grid->addWidget(label, row, 0);
-    auto statusLabel = new QLabel(status, parent);
-    //statusLabel->setAlignment(Qt::AlignLeft | flags);
-    grid->addWidget(statusLabel, row, 1);
-    label->show();
-    statusLabel->show();
-
-    return statusLabel;
-}
-
-SummaryViewScrollArea::SummaryViewScrollArea(QWidget *parent)
-    : QScrollArea(parent)
-{
-}
-
-void SummaryViewScrollArea::resizeEvent(QResizeEvent *e)
-{
-    Q_ASSERT(widget());
-
-    QSize s = e->size();
-
-    setMinimumWidth(widget()->minimumSizeHint().width() + verticalScrollBar()->width());
-    widget()->setMinimumWidth(s.width());
-
-    if (widget()->height() <= s.height()) {
-        widget()->setMinimumHeight(s.height());
-    } else {
-        widget()->setMinimumHeight(widget()->sizeHint().height());
-    }
-
-    QScrollArea::resizeEvent(e);
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -271,23 +457,13 @@ void SummaryViewScrollArea::resizeEvent(QResizeEvent *e)
 
 SummaryView::SummaryView(QObject *parent)
     : StatusView(parent)
-    , m_widget(new SummaryViewScrollArea)
+    , m_widget(new SummaryViewWidget(this))
 {
-    m_base = new QWidget;
-    m_base->setStyleSheet(QStringLiteral("QWidget { background-color: 'white'; }"));
-    m_widget->setWidget(m_base);
-
-    m_layout = new QGridLayout(m_base);
-    m_layout->setColumnStretch(1, 1);
-    m_layout->setSpacing(5);
-    m_layout->setMargin(5);
-
-    m_widget->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    m_widget->setMinimumHeight(150);
 }
 
 SummaryView::~SummaryView()
 {
+    qDeleteAll(m_items);
 }
 
 QWidget *SummaryView::widget() const
@@ -295,36 +471,53 @@ QWidget *SummaryView::widget() const
     return m_widget.data();
 }
 
+SummaryViewItem *SummaryView::createItem(unsigned int hostid)
+{
+    auto item = new SummaryViewItem(hostid, this);
+    m_items.insert(hostid, item);
+    m_widget->addItem(item);
+    return item;
+}
+
 void SummaryView::update(const Job &job)
 {
     if (!job.server) {
         return;
     }
 
-    SummaryViewItem *i = m_items[job.server];
+    SummaryViewItem *i = m_items.value(job.server);
     if (!i) {
-        i = new SummaryViewItem(job.server, m_base, this, m_layout);
-        m_items.insert(job.server, i);
-        m_widget->widget()->setMinimumHeight(m_widget->widget()->sizeHint().height());
+        i = createItem(job.server);
+    }
+    if (i->update(job)) {
+        m_widget->updateItem(i);
     }
-    i->update(job);
 
-    i = m_items[job.client];
-    if (i) {
-      i->updateClient(job);
+    i = m_items.value(job.client);
+    if (i && i->updateClient(job)) {
+        m_widget->updateItem(i);
     }
 }
 
+HostInfo::Fields SummaryView::hostFields() const
+{
+    return HostInfo::AddedField | HostInfo::NameField | HostInfo::ColorField;
+}
+
 void SummaryView::checkNode(unsigned int hostid)
 {
     HostInfo *hostInfo = hostInfoManager()->find(hostid);
+    SummaryViewItem *item = m_items.value(hostid);
 
     if (hostInfo && nameForHost(hostid).isNull()) {
-        delete m_items[hostid];
-        m_items.remove(hostid);
-    } else if (!m_items[hostid]) {
-        auto i = new SummaryViewItem(hostid, m_base, this, m_layout);
-        m_items.insert(hostid, i);
-	m_widget->widget()->setMinimumHeight(m_widget->widget()->sizeHint().height());
+        if (item) {
+            m_widget->removeItem(item);
+            m_items.remove(hostid);
+            delete item;
+        }
+    } else if (!item) {
+        createItem(hostid);
+    } else {
+        m_widget->updateItem(item);
     }
 }
@@ -21,58 +21,75 @@
 #ifndef SUMMARYVIEW_H
 #define SUMMARYVIEW_H
 
+#include "job.h"
 #include "statusview.h"
 
-#include <QScrollArea>
-#include <QResizeEvent>
-
-class QLabel;
-class QGridLayout;
+#include <QColor>
+#include <QMap>
+#include <QScopedPointer>
+#include <QSet>
+#include <QString>
+#include <QVector>
 
 class SummaryView;
-class SummaryViewScrollArea;
+class SummaryViewWidget;
 
+/**
+ * What the summary shows for one host
+ *
+ * The item has no widgets of its own, SummaryViewWidget paints it.
+ */
 class SummaryViewItem
 {
 public:
-    SummaryViewItem(unsigned int hostid, QWidget *parent, SummaryView *view, QGridLayout *layout);
-    ~SummaryViewItem();
-    void update(const Job &job);
-    void updateClient(const Job &job);
-
-private:
-    QLabel *addLine(const QString &caption, QWidget *parent, QGridLayout *grid,
-                    Qt::Alignment flags = Qt::AlignTop,
-                    const QString &status = QString());
-    void updateStats();
-     
-    struct JobHandler
+    struct JobSlot
     {
-        JobHandler()
-            : stateWidget(nullptr)
-            , sourceLabel(nullptr)
-            , stateLabel(nullptr) {}
-
-        QFrame *stateWidget;
-        QLabel *sourceLabel;
-        QLabel *stateLabel;
-        QString currentFile;
+        JobSlot()
+            : fileId(0)
+            , busy(false) {}
+
+        PathTable::PathId fileId;   ///< of the job in the slot
+        bool busy;
+        QColor color;               ///< of the client while busy
+        QString source;
+        QString state;
     };
 
-    QLabel *m_speedLabel;
-    QLabel *m_jobsLabel;
+    SummaryViewItem(unsigned int hostid, SummaryView *view);
 
-    int m_jobCount;
-    double m_totalJobsLength;
-    int m_finishedJobCount;
+    unsigned int hostId() const { return m_hostId; }
+    const QVector<JobSlot> &jobSlots() const { return m_jobSlots; }
+
+    /// @return true if the item has to be painted again
+    bool update(const Job &job);
+    bool updateClient(const Job &job);
+
+    /// Total jobs and their duration, as server
+    QString jobsText() const;
+    /// Job time percentiles, as client
+    QString speedText() const;
 
-    double m_totalRequestedJobsLength;
-    int m_requestedJobCount;
+    /// Position in the widget, maintained by SummaryViewWidget
+    int index() const { return m_index; }
+    void setIndex(int index) { m_index = index; }
+
+private:
+    void updateStats() const;
+
+    unsigned int m_hostId;
+    int m_jobCount;
+    int m_index;
 
     SummaryView *m_view;
 
-    QVector<JobHandler> m_jobHandlers;
-    QList<QWidget *> m_widgets;
+    QVector<JobSlot> m_jobSlots;
+    /// jobs counted in m_jobCount which did not finish yet
+    QSet<unsigned int> m_runningJobs;
+
+    // the statistics are only formatted when the item is painted
+    mutable bool m_statsDirty;
+    mutable QString m_jobsText;
+    mutable QString m_speedText;
 };
 
 class SummaryView
@@ -88,13 +105,14 @@ public:
     virtual void update(const Job &job) override;
     virtual void checkNode(unsigned int hostid) override;
     virtual QString id() const override { return QStringLiteral("summary"); }
+    virtual HostInfo::Fields hostFields() const override;
 
 private:
-    QScopedPointer<SummaryViewScrollArea> m_widget;
+    SummaryViewItem *createItem(unsigned int hostid);
+
+    QScopedPointer<SummaryViewWidget> m_widget;
 
     QMap<unsigned int, SummaryViewItem *> m_items;
-    QGridLayout *m_layout;
-    QWidget *m_base;
 };
 
 #endif